@@ -1,5 +1,7 @@
 import math
+import os
 import random
+import struct
 import threading
 import time
 from collections import deque
@@ -11,12 +13,40 @@ import serial.tools.list_ports
 
 
 BAUD_RATE = 38400
-BOARD_SIZE = 8
-CELL_SIZE = 60
+# Геометрію поля плата повідомляє командою 0x19; до відповіді — 8x8
+BOARD_ROWS = 8
+BOARD_COLS = 8
+MAX_CELL_SIZE = 60
+CELL_SIZE = MAX_CELL_SIZE
+# Форма групи згорання з пакета 0x1E (GameShape_t у game.h): 0 — лінія, далі L, T, хрест, інше
+SHAPE_LINE = 0
+
+PACKET_SIZE = 6
+# Усе поле одним кадром [61 rows cols клітинки по 4 біти CRC] замість пакетів 0x16,
+# зміни кроку анімації — кадром [62 rows cols маска кольори CRC]. Клієнт пропонує це
+# в 0x60; стара прошивка відповідає статусом FF і шле поле по клітинці.
+CMD_BOARD_PACKED = 0x61
+CMD_BOARD_DELTA = 0x62
+CAP_PACKED_BOARD = 0x01
+CAP_DELTA_FRAME = 0x02
+# Плата шле весь каскад без пауз, кроки програє клієнт — по одному за TIMELINE_STEP_MS
+CAP_CASCADE_BURST = 0x04
+TIMELINE_STEP_MS = 150  # Як anim_speed_ms у прошивці
+# Падіння — один кадр 0x62 з кінцевим станом замість кадру на кожен рядок; куди впала
+# кожна кулька, клієнт виводить сам (animate_falls)
+CAP_LOCAL_FALL = 0x08
+
+# Запис гри (replay.h): перед FINISH клієнт пише свій файл і просить у плати її (0x1F).
+# Обидва перевіряє match3_replay на ПК.
+REPLAY_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "replays")
+REPLAY_FORMAT_VERSION = 1
+GAME_ENGINE_VERSION = 1  # Як у game.h прошивки
+REPLAY_OP_SHUFFLE, REPLAY_OP_UNDO, REPLAY_OP_REDO, REPLAY_OP_SWAP = 0, 1, 2, 3
+REPLAY_FLAG_LOADED = 0x02
 
 # Початкові розміри вікна
 WIDTH, HEIGHT = 600, 820
-OFFSET_X = (WIDTH - BOARD_SIZE * CELL_SIZE) // 2
+OFFSET_X = (WIDTH - BOARD_COLS * CELL_SIZE) // 2
 OFFSET_Y = 160
 
 BG_COLOR = (18, 22, 40)
@@ -33,7 +63,9 @@ COLORS = {
     3: (0, 220, 90),
     4: (255, 225, 0),
     5: (180, 0, 255),
-    6: (255, 140, 0)
+    6: (255, 140, 0),
+    7: (0, 220, 220),
+    8: (255, 100, 180)
 }
 
 
@@ -59,6 +91,48 @@ def get_ports():
     return result
 
 
+def fmix32(x):
+    x ^= x >> 16
+    x = (x * 0x85EBCA6B) & 0xFFFFFFFF
+    x ^= x >> 13
+    x = (x * 0xC2B2AE35) & 0xFFFFFFFF
+    x ^= x >> 16
+    return x
+
+
+def replay_swap_code(r1, c1, r2, c2, rows, cols):
+    # Спершу горизонтальні обміни (r,c)-(r,c+1) по рядках, далі вертикальні
+    r0, c0 = min(r1, r2), min(c1, c2)
+    if r1 == r2:
+        return REPLAY_OP_SWAP + r0 * (cols - 1) + c0
+    return REPLAY_OP_SWAP + rows * (cols - 1) + r0 * cols + c0
+
+
+def build_replay(seed, rows, cols, colors, flags, score, fp, codes):
+    body = bytearray()
+    for code in codes:  # varint (LEB128)
+        while code > 0x7F:
+            body.append((code & 0x7F) | 0x80)
+            code >>= 7
+        body.append(code)
+    header = b"M3RP" + bytes([REPLAY_FORMAT_VERSION, GAME_ENGINE_VERSION,
+                              rows, cols, colors, flags])
+    header += struct.pack("<IIII", seed, score, fp, len(codes))
+    return header + body
+
+
+def board_fingerprint(colors):
+    # Те саме, що Game_Fingerprint на платі: XOR обох половин ключів Zobrist
+    fp = 0
+    for r, row in enumerate(colors):
+        for c, color in enumerate(row):
+            if color:
+                x = (r << 9) | (c << 4) | color
+                fp ^= fmix32((x + 0x7F4A7C15) & 0xFFFFFFFF)
+                fp ^= fmix32((x + 0x9E3779B9) & 0xFFFFFFFF)
+    return fp
+
+
 class BgParticle:
     def __init__(self):
         self.reset(random_y=True)
@@ -234,8 +308,8 @@ class Match3Game:
         self.font_hint = pygame.font.SysFont("Segoe UI", 18)
 
         self.board = [
-            [AnimCell(r, c) for c in range(BOARD_SIZE)]
-            for r in range(BOARD_SIZE)
+            [AnimCell(r, c) for c in range(BOARD_COLS)]
+            for r in range(BOARD_ROWS)
         ]
         self.particles = []
         self.floating_texts = []
@@ -255,7 +329,21 @@ class Match3Game:
         self.current_slot = None
         self.last_action_time = time.time()
         self.hint_cells = None
-        self.pending_explosions = set()
+        self.hint_request_time = 0
+        self.game_seed = 0
+        self.num_colors = 6
+        self.replay_codes = []  # Дії цієї гри в кодах replay.h
+        self.replay_flags = 0
+        self.replay_pending = False  # Чекаємо 0x15, щоб записати файл клієнта
+        self.sent_swap = None
+        self.mcu_replay = None  # Файл плати, що приходить пакетами 0x1F
+        self.mcu_replay_len = 0
+        self.group_left = 0  # Скільки ще згорілих клітинок належать групі з останнього 0x1E
+        self.group_particles = 18
+        self.step_groups = deque()  # Заголовки 0x1E, чиї клітинки прийдуть у кадрі 0x62
+        self.board_caps = 0  # Можливості, погоджені з платою через 0x60
+        self.timeline = deque()  # Пакети каскаду, що ще не програні (CAP_CASCADE_BURST)
+        self.timeline_next = 0.0  # Коли програвати наступний крок
         self.pending_swap = None
         self.received_0x16_during_busy = False
 
@@ -306,13 +394,29 @@ class Match3Game:
         self.info_timer = duration
         self.info_color = color
 
-    def update_layout(self):
-        global OFFSET_X, OFFSET_Y
-        OFFSET_X = (WIDTH - BOARD_SIZE * CELL_SIZE) // 2
-        OFFSET_Y = (HEIGHT - BOARD_SIZE * CELL_SIZE) // 2 - 30
+    def set_geometry(self, rows, cols):
+        global BOARD_ROWS, BOARD_COLS
+        if (rows, cols) == (BOARD_ROWS, BOARD_COLS) or rows == 0 or cols == 0:
+            return
+        BOARD_ROWS, BOARD_COLS = rows, cols
+        self.board = [
+            [AnimCell(r, c) for c in range(BOARD_COLS)]
+            for r in range(BOARD_ROWS)
+        ]
+        self.selected = None
+        self.hint_cells = None
+        self.update_layout()
 
-        for r in range(BOARD_SIZE):
-            for c in range(BOARD_SIZE):
+    def update_layout(self):
+        global OFFSET_X, OFFSET_Y, CELL_SIZE
+        # Велике поле зменшує клітинки, щоб вміститися у вікно
+        CELL_SIZE = max(8, min(MAX_CELL_SIZE, (WIDTH - 40) // BOARD_COLS,
+                               (HEIGHT - 300) // BOARD_ROWS))
+        OFFSET_X = (WIDTH - BOARD_COLS * CELL_SIZE) // 2
+        OFFSET_Y = (HEIGHT - BOARD_ROWS * CELL_SIZE) // 2 - 30
+
+        for r in range(BOARD_ROWS):
+            for c in range(BOARD_COLS):
                 cell = self.board[r][c]
                 cell.x = OFFSET_X + c * CELL_SIZE + CELL_SIZE // 2
                 cell.target_y = OFFSET_Y + r * CELL_SIZE + CELL_SIZE // 2
@@ -373,16 +477,48 @@ class Match3Game:
             self.send(0x20, i, ord(chunk[0]), ord(chunk[1]), ord(chunk[2]))
             time.sleep(0.05)
 
+    def split_frames(self, rx):
+        # Вирізає з потоку цілі кадри: пакети по 6 байт і кадри поля 0x61 / 0x62.
+        # Після битого CRC зсувається на байт, щоб знайти початок наступного.
+        frames = []
+        while len(rx) >= PACKET_SIZE:
+            if (rx[0] in (CMD_BOARD_PACKED, CMD_BOARD_DELTA) and
+                    0 < rx[1] <= 32 and 0 < rx[2] <= 32):
+                cells = rx[1] * rx[2]
+                if rx[0] == CMD_BOARD_PACKED:
+                    n = 3 + (cells + 1) // 2
+                else:
+                    mask_len = (cells + 7) // 8
+                    if len(rx) < 3 + mask_len:
+                        break
+                    changed = sum(bin(b).count("1") for b in rx[3:3 + mask_len])
+                    n = 3 + mask_len + (changed + 1) // 2
+                if len(rx) < n + 1:
+                    break
+                if self.crc8(rx[:n]) == rx[n]:
+                    frames.append(bytes(rx[:n + 1]))
+                    del rx[:n + 1]
+                    continue
+            elif self.crc8(rx[:5]) == rx[5]:
+                frames.append(bytes(rx[:PACKET_SIZE]))
+                del rx[:PACKET_SIZE]
+                continue
+            del rx[0]
+        return frames
+
     def reader_loop(self):
+        rx = bytearray()
         while self.running:
             if self.connected and self.ser and self.ser.is_open:
                 try:
-                    if self.ser.in_waiting >= 6:
-                        raw = self.ser.read(6)
-                        if len(raw) == 6 and self.crc8(raw[:5]) == raw[5]:
-                            with self.lock:
-                                self.queue.append(raw)
-                            self.last_rx_time = time.time()
+                    # Чекає перший байт не довше за timeout порту, далі забирає все, що вже прийшло
+                    rx += self.ser.read(self.ser.in_waiting or 1)
+                    frames = self.split_frames(rx)
+                    if frames:
+                        with self.lock:
+                            self.queue.extend(frames)
+                        self.last_rx_time = time.time()
+                    continue
                 except Exception:
                     if self.connected:
                         self.show_msg(
@@ -390,6 +526,7 @@ class Match3Game:
                             180, (255, 60, 60)
                         )
                         self.disconnect()
+            rx.clear()
             time.sleep(0.01)
 
     def sync_board_data(self, delay=0.0):
@@ -401,6 +538,14 @@ class Match3Game:
         self.temp_slots = {i: ['\x00'] * 12 for i in range(3)}
         self.temp_leaderboard_names.clear()
 
+        self.board_caps = 0
+        with self.lock:
+            self.timeline.clear()
+        self.send(0x60, CAP_PACKED_BOARD | CAP_DELTA_FRAME | CAP_CASCADE_BURST | CAP_LOCAL_FALL)
+        time.sleep(0.05)
+        self.send(0x19)
+        time.sleep(0.05)
+
         for i in range(3):
             self.send(0x32, i, 0, 0, 0)
             time.sleep(0.05)
@@ -413,6 +558,7 @@ class Match3Game:
         time.sleep(0.1)
         self.send(0x30, slot_idx)
         time.sleep(0.3)
+        self.request_replays()
         self.send(0x12, 0xFF)
         time.sleep(0.3)
         self.sync_board_data()
@@ -440,6 +586,7 @@ class Match3Game:
             )
             time.sleep(0.4)
 
+        self.request_replays()
         self.send(0x12, 0xFF)
         time.sleep(0.4)
 
@@ -447,6 +594,23 @@ class Match3Game:
         self.exiting_game = False
         self.state = "MENU"
 
+    def request_replays(self):
+        # Перед FINISH: 0x15 — рахунок для файлу клієнта, 0x1F — файл плати
+        self.replay_pending = True
+        self.mcu_replay = None
+        self.send(0x15)
+        self.send(0x1F)
+
+    def write_replay(self, data, source):
+        seed = struct.unpack_from("<I", data, 10)[0]
+        try:
+            os.makedirs(REPLAY_DIR, exist_ok=True)
+            name = f"{time.strftime('%Y%m%d_%H%M%S')}_{seed:08x}_{source}.m3r"
+            with open(os.path.join(REPLAY_DIR, name), "wb") as f:
+                f.write(data)
+        except OSError:
+            self.show_msg("ERROR: REPLAY NOT SAVED!", 120, (255, 60, 60))
+
     def connect(self):
         if self.connected or not self.available_ports:
             return
@@ -457,8 +621,8 @@ class Match3Game:
             self.last_rx_time = time.time()
             self.show_msg("CONNECTED TO " + port, 120, (100, 255, 100))
 
-            for r in range(BOARD_SIZE):
-                for c in range(BOARD_SIZE):
+            for r in range(BOARD_ROWS):
+                for c in range(BOARD_COLS):
                     self.board[r][c].color = 0
 
             threading.Thread(
@@ -482,256 +646,357 @@ class Match3Game:
         self.score = 0
         self.busy = False
         self.selected = None
-        self.pending_explosions.clear()
+        self.group_left = 0
         self.pending_swap = None
         self.last_action_time = time.time()
         self.hint_cells = None
         self.floating_texts.clear()
+        self.replay_codes = []
+        self.replay_flags = 0
 
-        for r in range(BOARD_SIZE):
-            for c in range(BOARD_SIZE):
+        for r in range(BOARD_ROWS):
+            for c in range(BOARD_COLS):
                 self.board[r][c].color = 0
 
+        # Зерно нового поля: ця ж пара (seed, ходи) відтворює гру офлайн
+        self.game_seed = random.getrandbits(32) or 1
         self.send_player_name()
-        self.send(0x10)
+        self.send(0x10, (self.game_seed >> 24) & 0xFF, (self.game_seed >> 16) & 0xFF,
+                  (self.game_seed >> 8) & 0xFF, self.game_seed & 0xFF)
         self.state = "PLAYING"
 
-    def create_explosion(self, x, y, color):
-        for _ in range(18):
+    def create_explosion(self, x, y, color, count=18):
+        for _ in range(count):
             self.particles.append(Particle(x, y, color))
 
-    def check_match_at(self, r, c):
-        color = self.board[r][c].color
-        if color == 0:
-            return False
-
-        count_h = 1
-        for i in range(c - 1, -1, -1):
-            if self.board[r][i].color == color:
-                count_h += 1
-            else:
-                break
-        for i in range(c + 1, BOARD_SIZE):
-            if self.board[r][i].color == color:
-                count_h += 1
-            else:
-                break
-        if count_h >= 3:
-            return True
-
-        count_v = 1
-        for i in range(r - 1, -1, -1):
-            if self.board[i][c].color == color:
-                count_v += 1
-            else:
-                break
-        for i in range(r + 1, BOARD_SIZE):
-            if self.board[i][c].color == color:
-                count_v += 1
-            else:
+    def explode_cell(self, cell, old_color, particles, per_ball):
+        self.create_explosion(cell.x, cell.y, COLORS[old_color], particles)
+        ft = FloatingText(
+            cell.x, cell.y - 15, f"+{per_ball}",
+            COLORS[old_color], self.font_small
+        )
+        self.floating_texts.append(ft)
+
+    def explode_groups(self, cleared):
+        # Групи — зв'язні області згорілих кульок одного кольору. cleared іде за рядками,
+        # як обхід Game_RemoveGroups, тож i-та знайдена група — i-й заголовок 0x1E.
+        left = {(r, c): color for r, c, color in cleared}
+        for r, c, color in cleared:
+            if not self.step_groups:
                 break
-        if count_v >= 3:
-            return True
-
-        return False
-
-    def find_possible_move(self):
-        for r in range(BOARD_SIZE):
-            for c in range(BOARD_SIZE):
-                if c < BOARD_SIZE - 1:
-                    self.board[r][c].color, self.board[r][c + 1].color = (
-                        self.board[r][c + 1].color,
-                        self.board[r][c].color
-                    )
-                    match_found = (
-                        self.check_match_at(r, c) or
-                        self.check_match_at(r, c + 1)
-                    )
-                    self.board[r][c].color, self.board[r][c + 1].color = (
-                        self.board[r][c + 1].color,
-                        self.board[r][c].color
-                    )
-                    if match_found:
-                        return ((r, c), (r, c + 1))
-
-                if r < BOARD_SIZE - 1:
-                    self.board[r][c].color, self.board[r + 1][c].color = (
-                        self.board[r + 1][c].color,
-                        self.board[r][c].color
-                    )
-                    match_found = (
-                        self.check_match_at(r, c) or
-                        self.check_match_at(r + 1, c)
-                    )
-                    self.board[r][c].color, self.board[r + 1][c].color = (
-                        self.board[r + 1][c].color,
-                        self.board[r][c].color
-                    )
-                    if match_found:
-                        return ((r, c), (r + 1, c))
-        return None
-
-    def detect_and_save_matches(self):
-        for r in range(BOARD_SIZE):
-            for c in range(BOARD_SIZE - 2):
+            if (r, c) not in left:
+                continue
+            size, info, points = self.step_groups.popleft()
+            particles = 18 if (info >> 4) == SHAPE_LINE else 32
+            per_ball = points // size if size else 0
+            del left[(r, c)]
+            stack = [(r, c)]
+            while stack:
+                gr, gc = stack.pop()
+                self.explode_cell(self.board[gr][gc], color, particles, per_ball)
+                for nb in ((gr - 1, gc), (gr + 1, gc), (gr, gc - 1), (gr, gc + 1)):
+                    if left.get(nb) == color:
+                        del left[nb]
+                        stack.append(nb)
+        self.step_groups.clear()
+
+    def animate_falls(self, before):
+        # Гравітація стискає стовпчик донизу, не міняючи порядку кульок: k-та знизу
+        # кулька до падіння — k-та знизу після. Решта згори — нові, вони падають з-над поля.
+        for c in range(BOARD_COLS):
+            old_rows = [r for r in range(BOARD_ROWS - 1, -1, -1) if before[r][c]]
+            spawned = BOARD_ROWS - len(old_rows)
+            for k, r in enumerate(range(BOARD_ROWS - 1, -1, -1)):
+                cell = self.board[r][c]
+                if k < len(old_rows):
+                    from_r = old_rows[k]
+                else:
+                    from_r = r - spawned
+                if from_r != r:
+                    cell.y = OFFSET_Y + from_r * CELL_SIZE + CELL_SIZE // 2
+
+    # Лише прогноз для відкату обміну; групи й очки згорання приходять від плати (0x1E)
+    def has_local_match(self):
+        for r in range(BOARD_ROWS):
+            for c in range(BOARD_COLS - 2):
                 color = self.board[r][c].color
                 if (color != 0 and
                         self.board[r][c + 1].color == color and
                         self.board[r][c + 2].color == color):
-                    self.pending_explosions.update(
-                        [(r, c), (r, c + 1), (r, c + 2)]
-                    )
-        for c in range(BOARD_SIZE):
-            for r in range(BOARD_SIZE - 2):
+                    return True
+        for c in range(BOARD_COLS):
+            for r in range(BOARD_ROWS - 2):
                 color = self.board[r][c].color
                 if (color != 0 and
                         self.board[r + 1][c].color == color and
                         self.board[r + 2][c].color == color):
-                    self.pending_explosions.update(
-                        [(r, c), (r + 1, c), (r + 2, c)]
-                    )
-
-        count = len(self.pending_explosions)
-        if count == 3:
-            self.score_per_ball = 10
-        elif count == 4:
-            self.score_per_ball = 15
-        elif count >= 5:
-            self.score_per_ball = 20
-        else:
-            self.score_per_ball = 10
+                    return True
+        return False
 
     def process_uart(self):
         with self.lock:
             while self.queue:
                 p = self.queue.popleft()
-                cmd = p[0]
-
-                if cmd == 0x16:
-                    self.received_0x16_during_busy = True
-                    r, c, color = p[1], p[2], p[3]
-                    if 0 <= r < BOARD_SIZE and 0 <= c < BOARD_SIZE:
-                        if color == 0:
-                            self.detect_and_save_matches()
-                        cell = self.board[r][c]
-                        old_color = cell.sync(color)
-
-                        if color == 0 and old_color and old_color != 0:
-                            if (r, c) in self.pending_explosions:
-                                self.create_explosion(
-                                    cell.x, cell.y, COLORS[old_color]
-                                )
-                                text_str = f"+{self.score_per_ball}"
-                                ft = FloatingText(
-                                    cell.x, cell.y - 15, text_str,
-                                    COLORS[old_color], self.font_small
-                                )
-                                self.floating_texts.append(ft)
-                                self.pending_explosions.discard((r, c))
-                        if color != 0:
-                            self.pending_explosions.discard((r, c))
-                        cell.update_position(r)
-
-                elif cmd == 0x11:
-                    self.busy = False
-                    if self.pending_swap and not self.received_0x16_during_busy:
-                        (r1, c1), (r2, c2), color1, color2 = self.pending_swap
-                        self.board[r1][c1].color = color1
-                        self.board[r2][c2].color = color2
-                    self.pending_swap = None
-
-                elif cmd == 0x15:
-                    self.score = (
-                        (p[1] << 24) | (p[2] << 16) | (p[3] << 8) | p[4]
+                # Каскад, надісланий одним пакетом, і все, що прийшло після нього, — у чергу кроків
+                if (self.board_caps & CAP_CASCADE_BURST and
+                        (self.timeline or p[0] in (0x1E, CMD_BOARD_DELTA))):
+                    self.timeline.append(p)
+                else:
+                    self.handle_packet(p)
+            self.play_timeline()
+
+        if self.connected and time.time() - self.last_rx_time > 3.0:
+            self.show_msg("ERROR: MCU NOT RESPONDING!", 180, (255, 60, 60))
+            self.disconnect()
+
+    def play_timeline(self):
+        # Кадр поля — один крок анімації: після нього чекаємо TIMELINE_STEP_MS,
+        # решту пакетів застосовуємо одразу, в порядку надходження
+        now = time.time()
+        while self.timeline and now >= self.timeline_next:
+            p = self.timeline.popleft()
+            self.handle_packet(p)
+            if p[0] in (CMD_BOARD_PACKED, CMD_BOARD_DELTA):
+                self.timeline_next = now + TIMELINE_STEP_MS / 1000
+
+    def handle_packet(self, p):
+        cmd = p[0]
+
+        if cmd == 0x16:
+            self.received_0x16_during_busy = True
+            r, c, color = p[1], p[2], p[3]
+            if 0 <= r < BOARD_ROWS and 0 <= c < BOARD_COLS:
+                cell = self.board[r][c]
+                old_color = cell.sync(color)
+
+                if color == 0 and old_color and self.group_left > 0:
+                    self.group_left -= 1
+                    self.explode_cell(
+                        cell, old_color, self.group_particles,
+                        self.score_per_ball
                     )
-                    clean_name = self.clean_text(self.player_name)
-                    if clean_name and clean_name != "EMPTY" and self.score > 0:
-                        if self.score > self.best_scores.get(clean_name, 0):
-                            self.best_scores[clean_name] = self.score
+                cell.update_position(r)
 
-                elif cmd == 0x30:
-                    pass
+        elif cmd == CMD_BOARD_DELTA:
+            self.received_0x16_during_busy = True
+            rows, cols = p[1], p[2]
+            if (rows, cols) != (BOARD_ROWS, BOARD_COLS):
+                self.send(0x1D)  # Поле іншої геометрії — просимо його цілком
+                return
+            mask_len = (rows * cols + 7) // 8
+            colors = p[3 + mask_len:]
+            cleared = []
+            # Кадр без груп 0x1E — падіння; з CAP_LOCAL_FALL це одразу кінцевий стан
+            falling = self.board_caps & CAP_LOCAL_FALL and not self.step_groups
+            if falling:
+                before = [[cell.color for cell in row] for row in self.board]
+            k = 0
+            for i in range(rows * cols):
+                if not (p[3 + i // 8] >> (i % 8)) & 1:
+                    continue
+                b = colors[k // 2]
+                color = b & 0x0F if k & 1 else b >> 4
+                k += 1
+                r, c = divmod(i, cols)
+                cell = self.board[r][c]
+                old_color = cell.sync(color)
+                if color == 0 and old_color:
+                    cleared.append((r, c, old_color))
+                cell.update_position(r)
+            # Порожніють і клітинки, з яких кулька впала; згоріли лише ті, що мають групу 0x1E
+            if cleared and self.step_groups:
+                self.explode_groups(cleared)
+            if falling:
+                self.animate_falls(before)
+
+        elif cmd == CMD_BOARD_PACKED:
+            self.received_0x16_during_busy = True
+            rows, cols = p[1], p[2]
+            self.set_geometry(rows, cols)
+            for i in range(rows * cols):
+                b = p[3 + i // 2]
+                r, c = divmod(i, cols)
+                cell = self.board[r][c]
+                cell.sync(b & 0x0F if i & 1 else b >> 4)
+                cell.update_position(r)
+
+        elif cmd == 0x1E:
+            # Група згорання: далі плата шле її клітинки з кольором 0
+            size, info = p[1], p[2]
+            points = (p[3] << 8) | p[4]
+            if self.board_caps & CAP_DELTA_FRAME:
+                # Клітинки групи прийдуть кадром 0x62 разом з рештою кроку
+                self.step_groups.append((size, info, points))
+            else:
+                self.group_left = size
+                self.score_per_ball = points // size if size else 0
+                self.group_particles = 18 if (info >> 4) == SHAPE_LINE else 32
+
+        elif cmd == 0x11:
+            self.busy = False
+            if p[4] == 0xAA and self.sent_swap:
+                self.replay_codes.append(
+                    replay_swap_code(*self.sent_swap, BOARD_ROWS, BOARD_COLS)
+                )
+            self.sent_swap = None
+            if self.pending_swap and not self.received_0x16_during_busy:
+                (r1, c1), (r2, c2), color1, color2 = self.pending_swap
+                self.board[r1][c1].color = color1
+                self.board[r2][c2].color = color2
+            self.pending_swap = None
+
+        elif cmd == 0x17:
+            if p[4] != 0xDD:
+                self.hint_cells = ((p[1], p[2]), (p[3], p[4]))
+
+        elif cmd == 0x60:
+            self.board_caps = p[1] if p[4] == 0xAA else 0
+
+        elif cmd == 0x19:
+            self.set_geometry(p[1], p[2])
+            if p[3]:
+                self.num_colors = p[3]
+
+        elif cmd in (0x1A, 0x1B):
+            self.selected = None
+            if p[4] == 0xEE:
+                what = "UNDO" if cmd == 0x1A else "REDO"
+                self.show_msg(f"NOTHING TO {what}!", 60)
+            else:
+                self.replay_codes.append(
+                    REPLAY_OP_UNDO if cmd == 0x1A else REPLAY_OP_REDO
+                )
+                self.send(0x15)
+
+        elif cmd == 0x1C:
+            fp = (p[1] << 24) | (p[2] << 16) | (p[3] << 8) | p[4]
+            colors = [[cell.color for cell in row] for row in self.board]
+            if (not self.busy and self.is_board_stable() and
+                    fp != board_fingerprint(colors)):
+                self.show_msg("DESYNC - RELOADING BOARD", 90)
+                self.send(0x1D)
+
+        elif cmd == 0x18:
+            self.hint_cells = None
+            if p[4] == 0xDD:
+                self.show_msg("NO MOVES - BOARD SHUFFLED!", 120)
+            else:
+                self.replay_codes.append(REPLAY_OP_SHUFFLE)
 
-                elif cmd == 0x31:
-                    if p[4] == 0xEE:
-                        self.show_msg(
-                            "ERROR: SLOT IS EMPTY!", 120, (255, 60, 60)
-                        )
-                        self.current_slot = None
-                    else:
-                        self.show_msg("GAME LOADED!", 120, (100, 255, 100))
-                        self.last_action_time = time.time()
-                        self.hint_cells = None
-                        self.floating_texts.clear()
-                        self.state = "PLAYING"
-
-                elif cmd in [0x33, 0x34, 0x35, 0x36]:
-                    slot = p[1]
-                    if slot < 3:
-                        chars = [chr(c) for c in p[2:5]]
-                        if cmd == 0x33:
-                            self.temp_slots[slot][0:3] = chars
-                        elif cmd == 0x34:
-                            self.temp_slots[slot][3:6] = chars
-                        elif cmd == 0x35:
-                            self.temp_slots[slot][6:9] = chars
-                        elif cmd == 0x36:
-                            self.temp_slots[slot][9:12] = chars
-
-                elif cmd == 0x32:
-                    slot = p[1]
-                    status = p[4]
-                    if slot < 3:
-                        if status == 0xAA:
-                            clean_name = self.clean_text(
-                                self.temp_slots[slot]
-                            )
-                            self.slot_names[slot] = (
-                                clean_name if clean_name else "EMPTY"
-                            )
-                        else:
-                            self.slot_names[slot] = "EMPTY"
-
-                elif cmd in [0x41, 0x43, 0x44, 0x45]:
-                    idx = p[1]
-                    if idx not in self.temp_leaderboard_names:
-                        self.temp_leaderboard_names[idx] = ['\x00'] * 10
-
-                    if cmd == 0x41:
-                        self.temp_leaderboard_names[idx][0:3] = [
-                            chr(c) for c in p[2:5]
-                        ]
-                    elif cmd == 0x43:
-                        self.temp_leaderboard_names[idx][3:6] = [
-                            chr(c) for c in p[2:5]
-                        ]
-                    elif cmd == 0x44:
-                        self.temp_leaderboard_names[idx][6:9] = [
-                            chr(c) for c in p[2:5]
-                        ]
-                    elif cmd == 0x45:
-                        self.temp_leaderboard_names[idx][9] = chr(p[2])
-
-                elif cmd == 0x42:
-                    idx = p[1]
-                    if idx < 5:
-                        score = (p[3] << 8) | p[4]
-                        raw_name = self.temp_leaderboard_names.get(
-                            idx, ['\x00'] * 10
-                        )
-                        clean_name = self.clean_text(raw_name)
+        elif cmd == 0x1F:
+            if self.mcu_replay is None:
+                if p[4] == 0xAA:
+                    self.mcu_replay_len = (p[1] << 8) | p[2]
+                    self.mcu_replay = bytearray()
+            else:
+                self.mcu_replay += p[1:5]
+                if len(self.mcu_replay) >= self.mcu_replay_len:
+                    self.write_replay(
+                        bytes(self.mcu_replay[:self.mcu_replay_len]), "mcu"
+                    )
+                    self.mcu_replay = None
 
-                        if clean_name and clean_name != "EMPTY" and score > 0:
-                            if score > self.best_scores.get(clean_name, 0):
-                                self.best_scores[clean_name] = score
+        elif cmd == 0x15:
+            self.score = (
+                (p[1] << 24) | (p[2] << 16) | (p[3] << 8) | p[4]
+            )
+            clean_name = self.clean_text(self.player_name)
+            if clean_name and clean_name != "EMPTY" and self.score > 0:
+                if self.score > self.best_scores.get(clean_name, 0):
+                    self.best_scores[clean_name] = self.score
+            if self.replay_pending:
+                # Усе, що плата надіслала до 0x15, уже на полі
+                self.replay_pending = False
+                colors = [[cell.color for cell in row] for row in self.board]
+                self.write_replay(build_replay(
+                    self.game_seed, BOARD_ROWS, BOARD_COLS, self.num_colors,
+                    self.replay_flags, self.score,
+                    board_fingerprint(colors), self.replay_codes
+                ), "pc")
+
+        elif cmd == 0x30:
+            pass
 
-        if self.connected and time.time() - self.last_rx_time > 3.0:
-            self.show_msg("ERROR: MCU NOT RESPONDING!", 180, (255, 60, 60))
-            self.disconnect()
+        elif cmd == 0x31:
+            if p[4] == 0xEE:
+                self.show_msg(
+                    "ERROR: SLOT IS EMPTY!", 120, (255, 60, 60)
+                )
+                self.current_slot = None
+            else:
+                self.show_msg("GAME LOADED!", 120, (100, 255, 100))
+                self.replay_codes = []
+                self.replay_flags = REPLAY_FLAG_LOADED
+                self.last_action_time = time.time()
+                self.hint_cells = None
+                self.floating_texts.clear()
+                self.state = "PLAYING"
+
+        elif cmd in [0x33, 0x34, 0x35, 0x36]:
+            slot = p[1]
+            if slot < 3:
+                chars = [chr(c) for c in p[2:5]]
+                if cmd == 0x33:
+                    self.temp_slots[slot][0:3] = chars
+                elif cmd == 0x34:
+                    self.temp_slots[slot][3:6] = chars
+                elif cmd == 0x35:
+                    self.temp_slots[slot][6:9] = chars
+                elif cmd == 0x36:
+                    self.temp_slots[slot][9:12] = chars
+
+        elif cmd == 0x32:
+            slot = p[1]
+            status = p[4]
+            if slot < 3:
+                if status == 0xAA:
+                    clean_name = self.clean_text(
+                        self.temp_slots[slot]
+                    )
+                    self.slot_names[slot] = (
+                        clean_name if clean_name else "EMPTY"
+                    )
+                else:
+                    self.slot_names[slot] = "EMPTY"
+
+        elif cmd in [0x41, 0x43, 0x44, 0x45]:
+            idx = p[1]
+            if idx not in self.temp_leaderboard_names:
+                self.temp_leaderboard_names[idx] = ['\x00'] * 10
+
+            if cmd == 0x41:
+                self.temp_leaderboard_names[idx][0:3] = [
+                    chr(c) for c in p[2:5]
+                ]
+            elif cmd == 0x43:
+                self.temp_leaderboard_names[idx][3:6] = [
+                    chr(c) for c in p[2:5]
+                ]
+            elif cmd == 0x44:
+                self.temp_leaderboard_names[idx][6:9] = [
+                    chr(c) for c in p[2:5]
+                ]
+            elif cmd == 0x45:
+                self.temp_leaderboard_names[idx][9] = chr(p[2])
+
+        elif cmd == 0x42:
+            idx = p[1]
+            if idx < 5:
+                score = (p[3] << 8) | p[4]
+                raw_name = self.temp_leaderboard_names.get(
+                    idx, ['\x00'] * 10
+                )
+                clean_name = self.clean_text(raw_name)
+
+                if clean_name and clean_name != "EMPTY" and score > 0:
+                    if score > self.best_scores.get(clean_name, 0):
+                        self.best_scores[clean_name] = score
 
     def is_board_stable(self):
-        for r in range(BOARD_SIZE):
-            for c in range(BOARD_SIZE):
+        if self.timeline:
+            return False
+        for r in range(BOARD_ROWS):
+            for c in range(BOARD_COLS):
                 cell = self.board[r][c]
                 if cell.color == 0 or abs(cell.y - cell.target_y) > 1.0:
                     return False
@@ -753,6 +1018,12 @@ class Match3Game:
                 if is_valid and len(self.player_name) < 15:
                     if ord(unicode) < 128:
                         self.player_name += unicode
+        elif self.state == "PLAYING" and not self.busy:
+            if pygame.key.get_mods() & pygame.KMOD_CTRL:
+                if key == pygame.K_z:
+                    self.send(0x1A)
+                elif key == pygame.K_y:
+                    self.send(0x1B)
 
     def click(self, pos):
         if self.exiting_game:
@@ -836,8 +1107,8 @@ class Match3Game:
                             self.player_name = self.slot_names[i]
                             self.current_slot = i
 
-                            for r in range(BOARD_SIZE):
-                                for c in range(BOARD_SIZE):
+                            for r in range(BOARD_ROWS):
+                                for c in range(BOARD_COLS):
                                     self.board[r][c].color = 0
                             self.score = 0
 
@@ -871,7 +1142,7 @@ class Match3Game:
             c = (pos[0] - OFFSET_X) // CELL_SIZE
             r = (pos[1] - OFFSET_Y) // CELL_SIZE
 
-            if not (0 <= r < BOARD_SIZE and 0 <= c < BOARD_SIZE):
+            if not (0 <= r < BOARD_ROWS and 0 <= c < BOARD_COLS):
                 return
 
             if self.selected is None:
@@ -888,16 +1159,14 @@ class Match3Game:
                     self.board[r1][c1].color = c2_color
                     self.board[r][c].color = c1_color
 
-                    self.pending_explosions.clear()
-                    self.detect_and_save_matches()
-
-                    if len(self.pending_explosions) > 0:
+                    if self.has_local_match():
                         self.pending_swap = None
                     else:
                         self.pending_swap = (
                             (r1, c1), (r, c), c1_color, c2_color
                         )
 
+                    self.sent_swap = (r1, c1, r, c)
                     self.send(0x11, r1, c1, r, c)
                 self.selected = None
 
@@ -1133,16 +1402,18 @@ class Match3Game:
             if (not self.busy and not self.exiting_game and
                     self.connected and self.is_board_stable()):
                 if time.time() - self.last_action_time > 10:
-                    if not self.hint_cells:
-                        self.hint_cells = self.find_possible_move()
+                    if (not self.hint_cells and
+                            time.time() - self.hint_request_time > 1.0):
+                        self.hint_request_time = time.time()
+                        self.send(0x17)
                 else:
                     self.hint_cells = None
             else:
                 self.last_action_time = time.time()
                 self.hint_cells = None
 
-            for r in range(BOARD_SIZE):
-                for c in range(BOARD_SIZE):
+            for r in range(BOARD_ROWS):
+                for c in range(BOARD_COLS):
                     x = OFFSET_X + c * CELL_SIZE
                     y = OFFSET_Y + r * CELL_SIZE
                     pygame.draw.rect(
@@ -1317,6 +1588,9 @@ class Match3Game:
                 if e.type == pygame.USEREVENT + 1:
                     if self.connected:
                         self.send(0x15)
+                        if (self.state == "PLAYING" and not self.busy and
+                                self.is_board_stable()):
+                            self.send(0x1C)
 
             self.clock.tick(60)
 
@@ -0,0 +1,181 @@
+#include "board_batch.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCH_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define BATCH_HAVE_X86 0
+#endif
+
+/* --- ПАМ'ЯТЬ --- */
+
+int BoardBatch_Alloc(BoardBatch_t *b, size_t capacity) {
+    memset(b, 0, sizeof(*b));
+    capacity = (capacity + 3) & ~(size_t)3;
+    if (capacity == 0) capacity = 4;
+    for (int k = 0; k <= GAME_NUM_COLORS; k++) {
+        b->planes[k] = aligned_alloc(BOARD_BATCH_ALIGN, capacity * sizeof(uint64_t));
+        if (!b->planes[k]) {
+            BoardBatch_Free(b);
+            return -1;
+        }
+        memset(b->planes[k], 0, capacity * sizeof(uint64_t));
+    }
+    b->capacity = capacity;
+    return 0;
+}
+
+void BoardBatch_Free(BoardBatch_t *b) {
+    for (int k = 0; k <= GAME_NUM_COLORS; k++) free(b->planes[k]);
+    memset(b, 0, sizeof(*b));
+}
+
+// Те саме, що BB_Build у game.c, але в площини пакета
+void BoardBatch_Set(BoardBatch_t *b, size_t i, const uint8_t board[BOARD_ROWS][BOARD_COLS]) {
+    uint64_t masks[GAME_NUM_COLORS + 1] = { 0 };
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        for (int c = 0; c < BOARD_COLS; c++) {
+            uint8_t color = board[r][c];
+            if (color <= GAME_NUM_COLORS) masks[color] |= (uint64_t)1 << (r * BOARD_COLS + c);
+        }
+    }
+    for (int k = 0; k <= GAME_NUM_COLORS; k++) b->planes[k][i] = masks[k];
+    if (i >= b->count) b->count = i + 1;
+}
+
+/* --- ЯДРА --- */
+
+#define KERNEL_NAME      Batch_KernelScalar
+#define KERNEL_ATTR
+#define VEC              uint64_t
+#define VEC_LANES        1
+#define V_LOAD(p)        (*(p))
+#define V_SET1(x)        ((uint64_t)(x))
+#define V_AND(a, b)      ((a) & (b))
+#define V_OR(a, b)       ((a) | (b))
+#define V_ANDNOT(a, b)   (~(a) & (b))
+#define V_SHL(a, n)      ((a) << (n))
+#define V_SHR(a, n)      ((a) >> (n))
+#define V_STORE(p, a)    (*(p) = (a))
+#include "batch_kernel.inc"
+#undef KERNEL_NAME
+#undef KERNEL_ATTR
+#undef VEC
+#undef VEC_LANES
+#undef V_LOAD
+#undef V_SET1
+#undef V_AND
+#undef V_OR
+#undef V_ANDNOT
+#undef V_SHL
+#undef V_SHR
+#undef V_STORE
+
+#if BATCH_HAVE_X86
+#define KERNEL_NAME      Batch_KernelSse2
+#define KERNEL_ATTR      __attribute__((target("sse2")))
+#define VEC              __m128i
+#define VEC_LANES        2
+#define V_LOAD(p)        _mm_load_si128((const __m128i *)(p))
+#define V_SET1(x)        _mm_set1_epi64x((long long)(x))
+#define V_AND(a, b)      _mm_and_si128((a), (b))
+#define V_OR(a, b)       _mm_or_si128((a), (b))
+#define V_ANDNOT(a, b)   _mm_andnot_si128((a), (b))
+#define V_SHL(a, n)      _mm_slli_epi64((a), (n))
+#define V_SHR(a, n)      _mm_srli_epi64((a), (n))
+#define V_STORE(p, a)    _mm_store_si128((__m128i *)(p), (a))
+#include "batch_kernel.inc"
+#undef KERNEL_NAME
+#undef KERNEL_ATTR
+#undef VEC
+#undef VEC_LANES
+#undef V_LOAD
+#undef V_SET1
+#undef V_AND
+#undef V_OR
+#undef V_ANDNOT
+#undef V_SHL
+#undef V_SHR
+#undef V_STORE
+
+#define KERNEL_NAME      Batch_KernelAvx2
+#define KERNEL_ATTR      __attribute__((target("avx2")))
+#define VEC              __m256i
+#define VEC_LANES        4
+#define V_LOAD(p)        _mm256_load_si256((const __m256i *)(p))
+#define V_SET1(x)        _mm256_set1_epi64x((long long)(x))
+#define V_AND(a, b)      _mm256_and_si256((a), (b))
+#define V_OR(a, b)       _mm256_or_si256((a), (b))
+#define V_ANDNOT(a, b)   _mm256_andnot_si256((a), (b))
+#define V_SHL(a, n)      _mm256_slli_epi64((a), (n))
+#define V_SHR(a, n)      _mm256_srli_epi64((a), (n))
+#define V_STORE(p, a)    _mm256_store_si256((__m256i *)(p), (a))
+#include "batch_kernel.inc"
+#undef KERNEL_NAME
+#undef KERNEL_ATTR
+#undef VEC
+#undef VEC_LANES
+#undef V_LOAD
+#undef V_SET1
+#undef V_AND
+#undef V_OR
+#undef V_ANDNOT
+#undef V_SHL
+#undef V_SHR
+#undef V_STORE
+#endif
+
+/* --- ВИБІР ЯДРА --- */
+
+typedef void (*BatchKernel_t)(const BoardBatch_t *b, uint8_t *match_out, uint8_t *moves_out);
+
+static const struct {
+    const char *name;
+    BatchKernel_t fn;
+} kKernels[BATCH_ISA_COUNT] = {
+    [BATCH_ISA_SCALAR] = { "scalar", Batch_KernelScalar },
+#if BATCH_HAVE_X86
+    [BATCH_ISA_SSE2]   = { "sse2",   Batch_KernelSse2 },
+    [BATCH_ISA_AVX2]   = { "avx2",   Batch_KernelAvx2 },
+#else
+    [BATCH_ISA_SSE2]   = { "sse2",   NULL },
+    [BATCH_ISA_AVX2]   = { "avx2",   NULL },
+#endif
+};
+
+static BatchIsa_t batch_isa = BATCH_ISA_COUNT; // Ще не обрано
+
+int BoardBatch_IsaSupported(BatchIsa_t isa) {
+    if (isa >= BATCH_ISA_COUNT || !kKernels[isa].fn) return 0;
+#if BATCH_HAVE_X86
+    if (isa == BATCH_ISA_SSE2) return __builtin_cpu_supports("sse2");
+    if (isa == BATCH_ISA_AVX2) return __builtin_cpu_supports("avx2");
+#endif
+    return 1;
+}
+
+BatchIsa_t BoardBatch_SetIsa(BatchIsa_t isa) {
+    if (isa >= BATCH_ISA_COUNT) isa = BATCH_ISA_AVX2;
+    while (!BoardBatch_IsaSupported(isa)) isa--; // Скалярне ядро є завжди
+    batch_isa = isa;
+    return isa;
+}
+
+const char *BoardBatch_IsaName(BatchIsa_t isa) {
+    return isa < BATCH_ISA_COUNT ? kKernels[isa].name : "?";
+}
+
+static BatchKernel_t Batch_Kernel(void) {
+    if (batch_isa == BATCH_ISA_COUNT) BoardBatch_SetIsa(BATCH_ISA_COUNT);
+    return kKernels[batch_isa].fn;
+}
+
+void BoardBatch_MatchPresent(const BoardBatch_t *b, uint8_t *out) {
+    Batch_Kernel()(b, out, NULL);
+}
+
+void BoardBatch_HasMoves(const BoardBatch_t *b, uint8_t *out) {
+    Batch_Kernel()(b, NULL, out);
+}
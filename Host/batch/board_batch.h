@@ -0,0 +1,48 @@
+#ifndef HOST_BOARD_BATCH_H_
+#define HOST_BOARD_BATCH_H_
+
+/* Пакет полів у форматі "структура масивів": для кожного кольору k —
+ * суцільний масив 64-бітних масок planes[k][i] (біт r * 8 + c, як у бітборді
+ * game.c). Одна маска — одна лінія SIMD-регістра: SSE2 обробляє 2 поля
+ * за інструкцію, AVX2 — 4. Результати збігаються з Game_IsMatchPresent і
+ * Game_HasPossibleMoves біт у біт. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+
+#if GAME_RUNTIME_GEOMETRY || BOARD_COLS != 8 || BOARD_ROWS > 8
+#error "BoardBatch packs a board into one uint64_t: fixed geometry, BOARD_COLS == 8, BOARD_ROWS <= 8"
+#endif
+
+#define BOARD_BATCH_ALIGN 32 // Вирівнювання площин під AVX2; місткість кратна 4
+
+typedef enum {
+    BATCH_ISA_SCALAR = 0,
+    BATCH_ISA_SSE2,
+    BATCH_ISA_AVX2,
+    BATCH_ISA_COUNT
+} BatchIsa_t;
+
+typedef struct {
+    size_t count;     // Заповнених полів
+    size_t capacity;  // Виділено (кратно 4, хвіст занулений — ні ліній, ні ходів)
+    uint64_t *planes[GAME_NUM_COLORS + 1]; // [0] — порожні клітинки
+} BoardBatch_t;
+
+int  BoardBatch_Alloc(BoardBatch_t *b, size_t capacity); // 0 — успіх
+void BoardBatch_Free(BoardBatch_t *b);
+void BoardBatch_Set(BoardBatch_t *b, size_t i, const uint8_t board[BOARD_ROWS][BOARD_COLS]);
+
+// out[i] = 1, якщо на полі i є лінія з трьох (семантика Game_IsMatchPresent)
+void BoardBatch_MatchPresent(const BoardBatch_t *b, uint8_t *out);
+// out[i] = 1, якщо на полі i є лінія або хід, що її утворює (семантика Game_HasPossibleMoves)
+void BoardBatch_HasMoves(const BoardBatch_t *b, uint8_t *out);
+
+// Яке ядро використовувати; недоступний на цьому процесорі набір замінюється найкращим доступним.
+// Типово — найкращий доступний. Повертає фактично обраний.
+BatchIsa_t BoardBatch_SetIsa(BatchIsa_t isa);
+int BoardBatch_IsaSupported(BatchIsa_t isa);
+const char *BoardBatch_IsaName(BatchIsa_t isa);
+
+#endif /* HOST_BOARD_BATCH_H_ */
@@ -0,0 +1,136 @@
+/* Пропускна здатність пакетних ядер (Host/batch) у полях за секунду.
+ *   match3_batch_bench [--boards N] [--min-time-ms T]
+ * Спершу кожне доступне ядро звіряється з Game_IsMatchPresent і
+ * Game_HasPossibleMoves з game.c на тих самих полях; розбіжність — код виходу 1. */
+#define _GNU_SOURCE
+#include "board_batch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double Bench_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint32_t Batch_Random(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+/* Суміш полів, щоб були всі випадки: свіжі поля з Game_Init (ходи є, ліній немає),
+ * ті самі з кількома випадковими клітинками (часто лінії), повністю випадкові
+ * з 3-6 кольорів, поля з порожніми клітинками і тупикові поля з 0-2 змінами (часто ходів немає). */
+static void Batch_MakeBoard(Game_t *g, uint32_t i, uint32_t *rng) {
+    Game_Setup(g, NULL, NULL);
+    Game_Init(g, i + 1);
+    switch (i % 5) {
+    case 0:
+        break;
+    case 1:
+        for (int n = Batch_Random(rng) % 4; n >= 0; n--) {
+            g->board[Batch_Random(rng) % BOARD_ROWS][Batch_Random(rng) % BOARD_COLS] = Batch_Random(rng) % GAME_NUM_COLORS + 1;
+        }
+        break;
+    case 2: {
+        uint32_t colors = 3 + Batch_Random(rng) % (GAME_NUM_COLORS - 2);
+        for (int r = 0; r < BOARD_ROWS; r++)
+            for (int c = 0; c < BOARD_COLS; c++) g->board[r][c] = Batch_Random(rng) % colors + 1;
+        break;
+    }
+    case 3:
+        for (int n = Batch_Random(rng) % 12; n >= 0; n--) {
+            g->board[Batch_Random(rng) % BOARD_ROWS][Batch_Random(rng) % BOARD_COLS] = 0;
+        }
+        break;
+    default: {
+        uint32_t shift = Batch_Random(rng) % GAME_NUM_COLORS;
+        for (int r = 0; r < BOARD_ROWS; r++)
+            for (int c = 0; c < BOARD_COLS; c++) g->board[r][c] = (r * 2 + c + shift) % GAME_NUM_COLORS + 1;
+        for (int n = Batch_Random(rng) % 3; n > 0; n--) {
+            g->board[Batch_Random(rng) % BOARD_ROWS][Batch_Random(rng) % BOARD_COLS] = Batch_Random(rng) % GAME_NUM_COLORS + 1;
+        }
+        break;
+    }
+    }
+    Game_MarkAllDirty(g);
+}
+
+int main(int argc, char **argv) {
+    size_t boards = 1 << 16;
+    double min_time_ms = 200.0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--boards") && i + 1 < argc) {
+            boards = strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--min-time-ms") && i + 1 < argc) {
+            min_time_ms = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--boards N] [--min-time-ms T]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    BoardBatch_t batch;
+    if (!boards || BoardBatch_Alloc(&batch, boards)) return 2;
+    uint8_t *ref_match = malloc(boards), *ref_moves = malloc(boards);
+    uint8_t *match = malloc(boards), *moves = malloc(boards);
+    size_t n_match = 0, n_moves = 0;
+
+    uint32_t rng = 0x12345678u;
+    for (size_t i = 0; i < boards; i++) {
+        Game_t g;
+        Batch_MakeBoard(&g, (uint32_t)i, &rng);
+        BoardBatch_Set(&batch, i, g.board);
+        ref_match[i] = Game_IsMatchPresent(&g) != 0;
+        ref_moves[i] = Game_HasPossibleMoves(&g) != 0;
+        n_match += ref_match[i];
+        n_moves += ref_moves[i];
+    }
+    printf("%zu boards: %zu with a line, %zu with a line or a move\n", boards, n_match, n_moves);
+    printf("%-8s %18s %18s\n", "kernel", "match boards/s", "moves boards/s");
+
+    int failed = 0;
+    for (int isa = 0; isa < BATCH_ISA_COUNT; isa++) {
+        if (!BoardBatch_IsaSupported((BatchIsa_t)isa)) {
+            printf("%-8s %18s %18s\n", BoardBatch_IsaName((BatchIsa_t)isa), "-", "-");
+            continue;
+        }
+        BoardBatch_SetIsa((BatchIsa_t)isa);
+
+        BoardBatch_MatchPresent(&batch, match);
+        BoardBatch_HasMoves(&batch, moves);
+        if (memcmp(match, ref_match, boards) || memcmp(moves, ref_moves, boards)) {
+            printf("%-8s MISMATCH with game.c\n", BoardBatch_IsaName((BatchIsa_t)isa));
+            failed = 1;
+            continue;
+        }
+
+        double rate[2];
+        for (int which = 0; which < 2; which++) {
+            double best = 1e300, total = 0.0;
+            while (total < min_time_ms * 1e6 / 2) {
+                double t0 = Bench_NowNs();
+                if (which) BoardBatch_HasMoves(&batch, moves);
+                else BoardBatch_MatchPresent(&batch, match);
+                double t = Bench_NowNs() - t0;
+                total += t;
+                if (t < best) best = t;
+            }
+            rate[which] = (double)boards * 1e9 / best;
+        }
+        printf("%-8s %18.0f %18.0f\n", BoardBatch_IsaName((BatchIsa_t)isa), rate[0], rate[1]);
+    }
+
+    free(ref_match);
+    free(ref_moves);
+    free(match);
+    free(moves);
+    BoardBatch_Free(&batch);
+    return failed;
+}
@@ -0,0 +1,13 @@
+#ifndef HOST_BENCH_BACKEND_H_
+#define HOST_BENCH_BACKEND_H_
+
+#include "bench.h"
+
+/* Випадки bench.c, зібрані з одним бекендом пошуку збігів (bench/bench_variant.c) */
+typedef struct {
+    const char *name; // "bitboard", "array", "swar"
+    const BenchCase_t *cases;
+    uint8_t count;
+} BenchBackend_t;
+
+#endif /* HOST_BENCH_BACKEND_H_ */
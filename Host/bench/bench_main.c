@@ -0,0 +1,168 @@
+/* Мікробенчмарки рушія на ПК: ті самі випадки, що й на платі (MCU/Core/Src/bench.c),
+ * для кожного бекенда пошуку збігів (bench/bench_variant.c).
+ *   match3_bench [--json] [--min-time-ms N] [--filter підрядок]
+ * Для кожного випадку: кількість ітерацій подвоюється до ~10 мс на прогін,
+ * далі прогони повторюються до --min-time-ms; звітується найкращий прогін. */
+#define _GNU_SOURCE
+#include "bench_backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef BENCH_COUNT_ALLOCS
+#define BENCH_COUNT_ALLOCS 0
+#endif
+
+// Той самий список, що й варіанти match3_bench у CMakeLists.txt; перший — бекенд прошивки
+#define BENCH_BACKENDS(X) \
+    X(bench_bitboard) \
+    X(bench_array) \
+    X(bench_swar)
+
+#define BENCH_DECLARE(v) extern const BenchBackend_t v##_backend;
+BENCH_BACKENDS(BENCH_DECLARE)
+#define BENCH_ENTRY(v) &v##_backend,
+static const BenchBackend_t *const backends[] = { BENCH_BACKENDS(BENCH_ENTRY) };
+#define BENCH_BACKEND_COUNT ((int)(sizeof(backends) / sizeof(backends[0])))
+#define BENCH_MAX_CASES     32
+
+static unsigned long bench_allocs;
+
+/* --- ЛІЧИЛЬНИК ВИДІЛЕНЬ ПАМ'ЯТІ ---
+ * Лінкується з -Wl,--wrap=malloc,... : рахуються виклики з бенчмарку
+ * й статичної libmatch3. Рушій не повинен виділяти нічого.
+ * У збірці Sanitize або зі спільною бібліотекою лічильник вимкнено. */
+#if BENCH_COUNT_ALLOCS
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    bench_allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    bench_allocs++;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t size) {
+    bench_allocs++;
+    return __real_realloc(p, size);
+}
+#endif
+
+typedef struct {
+    const char *name;
+    uint32_t iters;      // Ітерацій у найкращому прогоні
+    double ns_per_op;
+    double allocs_per_op; // < 0 — не вимірювалось
+} BenchResult_t;
+
+static double Bench_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static BenchResult_t Bench_RunCase(const BenchCase_t *bc, double min_time_ns) {
+    BenchResult_t res = { bc->name, 0, 0.0, 0.0 };
+    uint32_t iters = 1;
+    double t;
+
+    bc->setup();
+    for (;;) {
+        double t0 = Bench_NowNs();
+        bc->run(iters);
+        t = Bench_NowNs() - t0;
+        if (t >= 10e6 || iters >= (1u << 30)) break;
+        iters *= 2;
+    }
+
+    double best = t / iters, total = 0.0;
+    unsigned long allocs = 0, ops = 0;
+    while (total < min_time_ns) {
+        unsigned long a0 = bench_allocs;
+        double t0 = Bench_NowNs();
+        bc->run(iters);
+        t = Bench_NowNs() - t0;
+        allocs += bench_allocs - a0;
+        ops += iters;
+        total += t;
+        if (t / iters < best) best = t / iters;
+    }
+
+    res.iters = iters;
+    res.ns_per_op = best;
+    res.allocs_per_op = BENCH_COUNT_ALLOCS ? (double)allocs / (double)ops : -1.0;
+    return res;
+}
+
+int main(int argc, char **argv) {
+    int json = 0;
+    double min_time_ms = 200.0;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json")) {
+            json = 1;
+        } else if (!strcmp(argv[i], "--min-time-ms") && i + 1 < argc) {
+            min_time_ms = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--json] [--min-time-ms N] [--filter substring]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    BenchResult_t results[BENCH_BACKEND_COUNT][BENCH_MAX_CASES];
+    int count = 0;
+    for (int b = 0; b < BENCH_BACKEND_COUNT; b++) {
+        count = 0;
+        for (uint8_t i = 0; i < backends[b]->count && count < BENCH_MAX_CASES; i++) {
+            if (filter && !strstr(backends[b]->cases[i].name, filter)) continue;
+            results[b][count++] = Bench_RunCase(&backends[b]->cases[i], min_time_ms * 1e6);
+        }
+    }
+
+    if (json) {
+        // Плоский список з полем backend: mcu_bench.py --host бере випадки одного бекенда
+        printf("{\n  \"platform\": \"host\",\n  \"cases\": [\n");
+        for (int b = 0; b < BENCH_BACKEND_COUNT; b++) {
+            for (int i = 0; i < count; i++) {
+                const BenchResult_t *r = &results[b][i];
+                char allocs[32];
+                if (r->allocs_per_op < 0) snprintf(allocs, sizeof(allocs), "null");
+                else snprintf(allocs, sizeof(allocs), "%.3f", r->allocs_per_op);
+                printf("    {\"backend\": \"%s\", \"name\": \"%s\", \"iters\": %u, \"ns_per_op\": %.2f, "
+                       "\"ops_per_sec\": %.0f, \"allocs_per_op\": %s}%s\n",
+                       backends[b]->name, r->name, r->iters, r->ns_per_op, 1e9 / r->ns_per_op, allocs,
+                       b + 1 < BENCH_BACKEND_COUNT || i + 1 < count ? "," : "");
+            }
+        }
+        printf("  ]\n}\n");
+    } else {
+        // ns/op поряд для всіх бекендів; виділення — найбільше з них
+        printf("%-26s", "case");
+        for (int b = 0; b < BENCH_BACKEND_COUNT; b++) {
+            char head[32];
+            snprintf(head, sizeof(head), "%s ns/op", backends[b]->name);
+            printf(" %14s", head);
+        }
+        printf(" %10s\n", "allocs/op");
+        for (int i = 0; i < count; i++) {
+            double allocs = results[0][i].allocs_per_op;
+            printf("%-26s", results[0][i].name);
+            for (int b = 0; b < BENCH_BACKEND_COUNT; b++) {
+                printf(" %14.1f", results[b][i].ns_per_op);
+                if (results[b][i].allocs_per_op > allocs) allocs = results[b][i].allocs_per_op;
+            }
+            if (allocs < 0) printf(" %10s\n", "-");
+            else printf(" %10.3f\n", allocs);
+        }
+    }
+    return 0;
+}
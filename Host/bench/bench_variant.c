@@ -0,0 +1,15 @@
+/* Випадки MCU/Core/Src/bench.c для одного бекенда: bench.c разом з game.c під
+ * іменами з префіксом ENGINE_VARIANT (variant/engine_variant.h). */
+#include "engine_variant.h"
+#define bench_cases      VARIANT_SYM(bench_cases)
+#define bench_case_count VARIANT_SYM(bench_case_count)
+#define bench_sink       VARIANT_SYM(bench_sink)
+#include "../../MCU/Core/Src/game.c"
+#include "../../MCU/Core/Src/bench.c"
+#include "bench_backend.h"
+
+const BenchBackend_t VARIANT_SYM(backend) = {
+    VARIANT_BACKEND,
+    bench_cases,
+    sizeof(bench_cases) / sizeof(bench_cases[0]),
+};
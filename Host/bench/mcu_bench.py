@@ -0,0 +1,91 @@
+"""Запуск мікробенчмарків на платі (прошивка з GAME_BENCH=1, команда 0x50).
+
+    python mcu_bench.py COM5 [--mhz 48] [--json] [--host host.json] [--host-backend bitboard]
+
+--host: результат `match3_bench --json` з ПК — буде виведено поруч (випадки бекенда
+--host-backend; типово bitboard, як у прошивці).
+"""
+import argparse
+import json
+
+import serial
+
+# Порядок як у bench_cases[] (MCU/Core/Src/bench.c)
+CASES = [
+    "game_init",
+    "swap_hit",
+    "swap_miss",
+    "has_moves_dense",
+    "has_moves_near_deadlock",
+    "has_moves_deadlock",
+    "gravity_cascade",
+    "crc8_packet",
+]
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            if crc & 0x80:
+                crc = ((crc << 1) ^ 0x07) & 0xFF
+            else:
+                crc = (crc << 1) & 0xFF
+    return crc
+
+
+def run_case(ser, case_id):
+    p = bytearray([0x50, case_id, 0, 0, 0])
+    p.append(crc8(p))
+    ser.reset_input_buffer()
+    ser.write(p)
+    raw = ser.read(6)
+    if len(raw) != 6 or crc8(raw[:5]) != raw[5] or raw[0] != 0x50:
+        raise RuntimeError("no valid 0x50 reply for case %d (firmware built without GAME_BENCH?)" % case_id)
+    if raw[1] != case_id:
+        raise RuntimeError("board has %d cases, script expects %d" % (raw[2], len(CASES)))
+    return (raw[2] << 16) | (raw[3] << 8) | raw[4]
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("port")
+    ap.add_argument("--mhz", type=float, default=48.0, help="HCLK плати (HSI/2 * 12 = 48 МГц)")
+    ap.add_argument("--json", action="store_true")
+    ap.add_argument("--host", help="JSON з match3_bench --json для порівняння")
+    ap.add_argument("--host-backend", default="bitboard", help="бекенд з --host: bitboard, array, swar")
+    args = ap.parse_args()
+
+    # Один прогін триває ~50 мс плюс підготовка фікстур — таймаут із запасом
+    ser = serial.Serial(args.port, 38400, timeout=5)
+    cases = []
+    for i, name in enumerate(CASES):
+        cyc = run_case(ser, i)
+        ns = cyc * 1000.0 / args.mhz
+        cases.append({"name": name, "cycles_per_op": cyc, "ns_per_op": round(ns, 2),
+                      "ops_per_sec": round(1e9 / ns) if ns else None})
+    ser.close()
+
+    if args.json:
+        print(json.dumps({"platform": "stm32f051", "mhz": args.mhz, "cases": cases}, indent=2))
+        return
+
+    host = {}
+    if args.host:
+        with open(args.host) as f:
+            host = {c["name"]: c for c in json.load(f)["cases"]
+                    if c.get("backend", args.host_backend) == args.host_backend}
+
+    print("%-26s %10s %12s %12s %10s" % ("case", "cycles/op", "mcu ns/op", "host ns/op", "ratio"))
+    for c in cases:
+        h = host.get(c["name"])
+        if h:
+            print("%-26s %10d %12.1f %12.1f %10.0f" % (c["name"], c["cycles_per_op"], c["ns_per_op"],
+                                                       h["ns_per_op"], c["ns_per_op"] / h["ns_per_op"]))
+        else:
+            print("%-26s %10d %12.1f %12s %10s" % (c["name"], c["cycles_per_op"], c["ns_per_op"], "-", "-"))
+
+
+if __name__ == "__main__":
+    main()
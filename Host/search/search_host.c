@@ -0,0 +1,114 @@
+#include "search_host.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#define SEARCH_HOST_MAX_THREADS 256
+
+// Спільне для потоків одного кроку поглиблення
+typedef struct {
+    const Game_t *g;
+    const SearchConfig_t *cfg;
+    const SearchMove_t *order;  // Ходи від кращого за попередньою глибиною
+    int32_t *values;            // values[i] — цінність order[i] на цій глибині
+    uint16_t n;
+    uint8_t depth;
+    uint32_t start_us;
+    atomic_uint next;           // Наступний нерозглянутий хід
+    atomic_uint nodes;
+    atomic_int aborted;
+} SearchHostJob_t;
+
+uint32_t SearchHost_NowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+static int SearchHost_Probe(void *ctx, uint64_t key, int32_t *value) {
+    TtEntry_t e;
+    if (!TransTable_Probe(ctx, key, &e)) return 0;
+    *value = e.value;
+    return 1;
+}
+
+static void SearchHost_Store(void *ctx, uint64_t key, int32_t value, uint8_t depth) {
+    TtEntry_t e = { .value = value, .depth = depth, .bound = TT_BOUND_EXACT };
+    TransTable_Store(ctx, key, &e);
+}
+
+// Ключ кешу вже містить глибину, тож значення з таблиці завжди точне
+void SearchHost_AttachTable(SearchConfig_t *cfg, TransTable_t *tt) {
+    cfg->cache_probe = tt ? SearchHost_Probe : NULL;
+    cfg->cache_store = tt ? SearchHost_Store : NULL;
+    cfg->cache_ctx = tt;
+}
+
+static void *SearchHost_Worker(void *arg) {
+    SearchHostJob_t *job = arg;
+    SearchRun_t run;
+    Search_RunInit(&run, job->cfg, job->start_us, job->depth);
+
+    for (;;) {
+        unsigned i = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (i >= job->n || atomic_load_explicit(&job->aborted, memory_order_relaxed)) break;
+        job->values[i] = Search_EvaluateMove(job->g, &job->order[i].move, job->depth, &run);
+        if (run.aborted) {
+            atomic_store_explicit(&job->aborted, 1, memory_order_relaxed);
+            break;
+        }
+    }
+    atomic_fetch_add_explicit(&job->nodes, run.nodes, memory_order_relaxed);
+    return NULL;
+}
+
+uint16_t SearchHost_BestMoves(const Game_t *g, const SearchConfig_t *cfg, int threads,
+                              SearchMove_t *out, uint16_t k, SearchStats_t *stats) {
+    GameMove_t moves[GAME_MAX_MOVES];
+    SearchMove_t scored[GAME_MAX_MOVES];
+    int32_t values[GAME_MAX_MOVES];
+    pthread_t tid[SEARCH_HOST_MAX_THREADS];
+    uint16_t n = Game_FindMoves(g, moves, GAME_MAX_MOVES);
+    uint32_t start = cfg->now_us ? cfg->now_us() : 0;
+    uint32_t nodes = 0;
+    uint8_t done = 0;
+
+    if (threads < 1) threads = 1;
+    if (threads > SEARCH_HOST_MAX_THREADS) threads = SEARCH_HOST_MAX_THREADS;
+    for (uint16_t i = 0; i < n; i++) {
+        scored[i].move = moves[i];
+        scored[i].value = 0;
+    }
+
+    for (uint8_t depth = 1; n && depth <= cfg->max_depth; depth++) {
+        SearchHostJob_t job = { .g = g, .cfg = cfg, .order = scored, .values = values,
+                                .n = n, .depth = depth, .start_us = start };
+        atomic_init(&job.next, 0);
+        atomic_init(&job.nodes, 0);
+        atomic_init(&job.aborted, 0);
+
+        int t, started = 0;
+        int workers = threads < n ? threads : n;
+        for (t = 1; t < workers; t++) {
+            if (pthread_create(&tid[t], NULL, SearchHost_Worker, &job) != 0) break;
+            started++;
+        }
+        SearchHost_Worker(&job); // Викликач — теж робочий потік
+        for (t = 1; t <= started; t++) pthread_join(tid[t], NULL);
+
+        nodes += atomic_load(&job.nodes);
+        if (atomic_load(&job.aborted)) break;
+        done = depth;
+        for (uint16_t i = 0; i < n; i++) scored[i].value = values[i];
+        Search_SortMoves(scored, n);
+    }
+
+    if (stats) {
+        stats->depth = done;
+        stats->nodes = nodes;
+    }
+    if (k > n) k = n;
+    memcpy(out, scored, k * sizeof(SearchMove_t));
+    return k;
+}
@@ -0,0 +1,19 @@
+#ifndef HOST_SEARCH_HOST_H_
+#define HOST_SEARCH_HOST_H_
+
+/* Пошук ходу (search.c) на ПК: корінь ділиться між потоками — кожен бере
+ * наступний нерозглянутий хід, — а вузли гравця кешуються в спільній таблиці
+ * транспозицій. Цінність вузла залежить лише від поля й глибини, тож
+ * результат такий самий, як у Search_BestMoves, за будь-якої кількості потоків. */
+
+#include <stdint.h>
+#include "search.h"
+#include "transposition.h"
+
+uint32_t SearchHost_NowUs(void); // Монотонний годинник для SearchConfig_t.now_us
+void SearchHost_AttachTable(SearchConfig_t *cfg, TransTable_t *tt); // tt = NULL — без кешу
+
+uint16_t SearchHost_BestMoves(const Game_t *g, const SearchConfig_t *cfg, int threads,
+                              SearchMove_t *out, uint16_t k, SearchStats_t *stats);
+
+#endif /* HOST_SEARCH_HOST_H_ */
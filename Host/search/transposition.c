@@ -0,0 +1,82 @@
+#include "transposition.h"
+#include <stdlib.h>
+
+/* Дані слота (64 біти):
+ *   0..31 value | 32..39 depth | 40..41 bound | 42 has_move | 43 вертикальний хід |
+ *   44..48 r1 | 49..53 c1 | 63 слот зайнятий (щоб порожній слот не збігся з ключем 0) */
+#define TT_VALID (1ull << 63)
+
+#if BOARD_ROWS > 32 || BOARD_COLS > 32
+#error "TransTable packs a move into 5-bit row/column fields"
+#endif
+
+static uint64_t TransTable_Pack(const TtEntry_t *e) {
+    uint64_t d = (uint32_t)e->value | ((uint64_t)e->depth << 32) | ((uint64_t)(e->bound & 3) << 40) | TT_VALID;
+    if (e->has_move) {
+        d |= 1ull << 42;
+        d |= (uint64_t)(e->move.r2 != e->move.r1) << 43;
+        d |= (uint64_t)(e->move.r1 & 31) << 44;
+        d |= (uint64_t)(e->move.c1 & 31) << 49;
+    }
+    return d;
+}
+
+static void TransTable_Unpack(uint64_t d, TtEntry_t *e) {
+    e->value = (int32_t)(uint32_t)d;
+    e->depth = (uint8_t)(d >> 32);
+    e->bound = (uint8_t)((d >> 40) & 3);
+    e->has_move = (uint8_t)((d >> 42) & 1);
+    uint8_t vertical = (uint8_t)((d >> 43) & 1);
+    e->move.r1 = (uint8_t)((d >> 44) & 31);
+    e->move.c1 = (uint8_t)((d >> 49) & 31);
+    e->move.r2 = (uint8_t)(e->move.r1 + vertical);
+    e->move.c2 = (uint8_t)(e->move.c1 + !vertical);
+}
+
+int TransTable_Alloc(TransTable_t *tt, size_t bytes) {
+    size_t buckets = 1;
+    while (buckets * 2 * 2 * sizeof(TtSlot_t) <= bytes) buckets *= 2;
+    tt->slots = calloc(buckets * 2, sizeof(TtSlot_t));
+    if (!tt->slots) return -1;
+    tt->mask = buckets - 1;
+    return 0;
+}
+
+void TransTable_Free(TransTable_t *tt) {
+    free(tt->slots);
+    tt->slots = NULL;
+    tt->mask = 0;
+}
+
+void TransTable_Clear(TransTable_t *tt) {
+    for (uint64_t i = 0; i < 2 * (tt->mask + 1); i++) {
+        atomic_store_explicit(&tt->slots[i].check, 0, memory_order_relaxed);
+        atomic_store_explicit(&tt->slots[i].data, 0, memory_order_relaxed);
+    }
+}
+
+int TransTable_Probe(const TransTable_t *tt, uint64_t key, TtEntry_t *out) {
+    TtSlot_t *bucket = &tt->slots[2 * (key & tt->mask)];
+    for (int i = 0; i < 2; i++) {
+        uint64_t check = atomic_load_explicit(&bucket[i].check, memory_order_relaxed);
+        uint64_t data = atomic_load_explicit(&bucket[i].data, memory_order_relaxed);
+        if ((data & TT_VALID) && (check ^ data) == key) {
+            TransTable_Unpack(data, out);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Перший слот — той самий стан або не менша глибина; інакше другий, без умов
+void TransTable_Store(TransTable_t *tt, uint64_t key, const TtEntry_t *e) {
+    TtSlot_t *bucket = &tt->slots[2 * (key & tt->mask)];
+    uint64_t check = atomic_load_explicit(&bucket[0].check, memory_order_relaxed);
+    uint64_t old = atomic_load_explicit(&bucket[0].data, memory_order_relaxed);
+    TtSlot_t *slot = &bucket[1];
+    if (!(old & TT_VALID) || (check ^ old) == key || e->depth >= (uint8_t)(old >> 32)) slot = &bucket[0];
+
+    uint64_t data = TransTable_Pack(e);
+    atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+    atomic_store_explicit(&slot->check, key ^ data, memory_order_relaxed);
+}
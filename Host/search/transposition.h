@@ -0,0 +1,46 @@
+#ifndef HOST_TRANSPOSITION_H_
+#define HOST_TRANSPOSITION_H_
+
+/* Таблиця транспозицій для пошуку вперед (підказка, ІІ, розв'язувач):
+ * ключ — Game_t.hash (за потреби змішаний зі станом генератора чи глибиною).
+ * Кошик — два слоти: перший зберігає найглибший результат, другий — останній.
+ * Без блокувань: слот — два 64-бітні атоміки (ключ ^ дані, дані); запис,
+ * розірваний іншим потоком, не проходить перевірку ключа й читається як промах. */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+
+typedef enum {
+    TT_BOUND_EXACT = 0,
+    TT_BOUND_LOWER,  // Справжнє значення >= value
+    TT_BOUND_UPPER,  // Справжнє значення <= value
+} TtBound_t;
+
+typedef struct {
+    int32_t    value;
+    uint8_t    depth;    // Глибина пошуку, що дала value; більша витісняє меншу
+    uint8_t    bound;    // TtBound_t
+    uint8_t    has_move; // 0 — move не заповнено
+    GameMove_t move;     // Найкращий хід із цього стану
+} TtEntry_t;
+
+typedef struct {
+    _Atomic uint64_t check; // key ^ data
+    _Atomic uint64_t data;
+} TtSlot_t;
+
+typedef struct {
+    TtSlot_t *slots;    // 2 * (mask + 1) слотів
+    uint64_t  mask;     // Кошиків — степінь двійки
+} TransTable_t;
+
+int  TransTable_Alloc(TransTable_t *tt, size_t bytes); // Найбільший степінь двійки кошиків у межах bytes; 0 — успіх
+void TransTable_Free(TransTable_t *tt);
+void TransTable_Clear(TransTable_t *tt); // Не одночасно з пошуком
+
+int  TransTable_Probe(const TransTable_t *tt, uint64_t key, TtEntry_t *out); // 1 — знайдено
+void TransTable_Store(TransTable_t *tt, uint64_t key, const TtEntry_t *e);
+
+#endif /* HOST_TRANSPOSITION_H_ */
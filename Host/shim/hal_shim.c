@@ -0,0 +1,79 @@
+#define _GNU_SOURCE
+#include "stm32f0xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+/* --- FLASH ---
+ * Сторінки відображаються за фіксованою адресою до main(), щоб
+ * (GameSaveData_t *)FLASH_SAVE_ADDR вказував на справжню пам'ять.
+ * Як і на МК, запис може лише скидати біти (1 -> 0); до стирання не повертаються. */
+
+static int flash_unlocked;
+
+__attribute__((constructor))
+static void HostFlash_Map(void) {
+    void *p = mmap((void *)(uintptr_t)HOST_FLASH_EMU_ADDR, HOST_FLASH_EMU_SIZE,
+                   PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p != (void *)(uintptr_t)HOST_FLASH_EMU_ADDR) {
+        fprintf(stderr, "hal_shim: cannot map emulated flash at 0x%08X\n", HOST_FLASH_EMU_ADDR);
+        abort();
+    }
+    HostFlash_EraseAll();
+}
+
+static int HostFlash_InRange(uint32_t addr, uint32_t size) {
+    return addr >= HOST_FLASH_EMU_ADDR && size <= HOST_FLASH_EMU_SIZE &&
+           addr - HOST_FLASH_EMU_ADDR <= HOST_FLASH_EMU_SIZE - size;
+}
+
+void HostFlash_EraseAll(void) {
+    memset((void *)(uintptr_t)HOST_FLASH_EMU_ADDR, 0xFF, HOST_FLASH_EMU_SIZE);
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+    flash_unlocked = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+    flash_unlocked = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError) {
+    *PageError = 0xFFFFFFFFU;
+    if (!flash_unlocked || pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES ||
+        pEraseInit->PageAddress % FLASH_PAGE_SIZE != 0 ||
+        !HostFlash_InRange(pEraseInit->PageAddress, pEraseInit->NbPages * FLASH_PAGE_SIZE)) {
+        *PageError = pEraseInit->PageAddress;
+        return HAL_ERROR;
+    }
+    memset((void *)(uintptr_t)pEraseInit->PageAddress, 0xFF, pEraseInit->NbPages * FLASH_PAGE_SIZE);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data) {
+    if (!flash_unlocked || TypeProgram != FLASH_TYPEPROGRAM_WORD ||
+        Address % 4 != 0 || !HostFlash_InRange(Address, 4)) {
+        return HAL_ERROR;
+    }
+    uint32_t *cell = (uint32_t *)(uintptr_t)Address;
+    *cell &= (uint32_t)Data;
+    return HAL_OK;
+}
+
+/* --- SYSTICK --- */
+
+uint32_t HAL_GetTick(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+void HAL_Delay(uint32_t Delay) {
+    struct timespec ts = { (time_t)(Delay / 1000u), (long)(Delay % 1000u) * 1000000L };
+    nanosleep(&ts, NULL);
+}
@@ -0,0 +1,43 @@
+#ifndef HOST_SHIM_STM32F0XX_HAL_H_
+#define HOST_SHIM_STM32F0XX_HAL_H_
+
+/* Мінімальна заміна HAL для збирання game.c / save.c на ПК.
+ * Лише те, що ці модулі реально використовують: Flash і системний таймер.
+ * Емульована Flash лежить за тими самими адресами, що й на STM32F051,
+ * тож save.c читає її через ті самі приведення вказівників. */
+
+#include <stdint.h>
+
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define FLASH_BASE              0x08000000U
+#define FLASH_PAGE_SIZE         0x400U
+#define FLASH_TYPEERASE_PAGES   (0x00U)
+#define FLASH_TYPEPROGRAM_WORD  (0x02U)
+
+/* Емулюється лише хвіст Flash, де save.c тримає свої сторінки */
+#define HOST_FLASH_EMU_ADDR     0x0800F000U
+#define HOST_FLASH_EMU_SIZE     0x1000U
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t PageAddress;
+    uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+
+uint32_t HAL_GetTick(void);  // Мілісекунди монотонного годинника ПК
+void HAL_Delay(uint32_t Delay);
+
+void HostFlash_EraseAll(void); // Стерти емульовану Flash (0xFF), напр. між прогонами
+
+#endif /* HOST_SHIM_STM32F0XX_HAL_H_ */
@@ -0,0 +1,350 @@
+/* Підбір балансу: самогра рушія game.c на сітці "таблиця очок × кольори × розмір поля".
+ *   match3_balance [--table A,B,C]... [--colors K,...] [--sizes RxC,...] [--games N] [--seed-base S]
+ *                  [--threads T] [--policy first|random|greedy|search] [--max-moves M]
+ *                  [--refill-no-match] [--csv | --json]
+ * --table — очки за 3, 4 і 5+ кульок (Game_SetScoreTable), можна кілька разів.
+ * Для кожної комбінації: середнє й p10/p50/p90/p99 рахунку, ходів до тупика й глибини
+ * каскаду на хід. Розміри й кольори, відмінні від зібраних, — лише з GAME_RUNTIME_GEOMETRY.
+ *
+ * Уся сітка — одне завдання: потоки беруть порції (комбінація, зерна) з атомарного
+ * лічильника. Гра залежить лише від комбінації й зерна, її результат пишеться у свою
+ * клітинку масиву, а гістограми цілочисельні — тож вихід не залежить від кількості потоків. */
+#include "game.h"
+#include "policy.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BAL_CHUNK        64  // Зерен за одне взяття
+#define BAL_MAX_LIST     16  // Найбільше таблиць, кількостей кольорів чи розмірів у сітці
+#define BAL_MAX_MOVES    1000000
+#define BAL_DEPTH_BINS   64
+#define BAL_CACHE_LINE   64
+
+typedef struct {
+    uint16_t table[GAME_SCORE_TABLE_SIZE];
+    uint8_t  rows, cols, colors;
+    uint32_t *score;   // [games] — фінальний рахунок кожної гри
+    uint32_t *length;  // [games] — ходів до тупика (або --max-moves)
+} BalConfig_t;
+
+typedef struct {
+    uint64_t capped;
+    uint64_t depth[BAL_DEPTH_BINS]; // Глибина каскаду на кожен хід (0 — без комбо)
+} BalStats_t;
+
+typedef struct {
+    BalStats_t *stats;  // [configs] — у кожного потоку свої
+    pthread_t thread;
+} __attribute__((aligned(BAL_CACHE_LINE))) BalWorker_t;
+
+static struct {
+    BalConfig_t configs[BAL_MAX_LIST * BAL_MAX_LIST * BAL_MAX_LIST];
+    int count;
+    uint32_t games, seed_base, max_moves;
+    uint8_t refill_no_match;
+    SimPolicy_t policy;
+    atomic_ullong next;   // Наступна порція: configs * games ігор підряд
+} pool;
+
+static void Bal_CountStep(Game_t *g, void *ctx) {
+    (void)g;
+    (*(uint32_t *)ctx)++;
+}
+
+static void Bal_PlayGame(const BalConfig_t *cfg, uint32_t idx, BalStats_t *st) {
+    Game_t g;
+    uint32_t steps;
+    uint32_t seed = pool.seed_base + idx;
+    uint32_t rng = seed * 0x9E3779B9u + 1;
+    uint32_t moves = 0;
+    GameMove_t m;
+
+    // Без покрокових кадрів колбек викликається раз на падіння і раз на кожне згорання комбо
+    Game_Setup(&g, Bal_CountStep, &steps);
+    Game_SetStepFrames(&g, 0);
+    Game_SetRefillNoMatch(&g, pool.refill_no_match);
+    Game_SetScoreTable(&g, cfg->table);
+    Game_SetGeometry(&g, cfg->rows, cfg->cols, cfg->colors); // Перевірено в main
+    Game_Init(&g, seed);
+
+    while (moves < pool.max_moves && pool.policy(&g, &rng, &m)) {
+        Game_Swap(&g, m.r1, m.c1, m.r2, m.c2);
+        steps = 0;
+        Game_RunGravityLoop(&g);
+        uint32_t depth = (steps - 1) / 2;
+        st->depth[depth < BAL_DEPTH_BINS ? depth : BAL_DEPTH_BINS - 1]++;
+        moves++;
+    }
+    if (moves == pool.max_moves && Game_HasPossibleMoves(&g)) st->capped++;
+    cfg->score[idx] = g.score;
+    cfg->length[idx] = moves;
+}
+
+static void *Bal_Worker(void *arg) {
+    BalWorker_t *w = arg;
+    uint64_t total = (uint64_t)pool.count * pool.games;
+    for (;;) {
+        uint64_t b = atomic_fetch_add(&pool.next, BAL_CHUNK);
+        if (b >= total) break;
+        uint64_t e = b + BAL_CHUNK < total ? b + BAL_CHUNK : total;
+        for (uint64_t i = b; i < e; i++) {
+            int c = (int)(i / pool.games);
+            Bal_PlayGame(&pool.configs[c], (uint32_t)(i % pool.games), &w->stats[c]);
+        }
+    }
+    return NULL;
+}
+
+/* --- ЗВІТ --- */
+
+typedef struct {
+    double mean;
+    uint32_t p10, p50, p90, p99, max;
+} BalSummary_t;
+
+static int Cmp_U32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Найменше значення, до якого включно набирається частка q (nearest rank)
+static uint32_t Sorted_Quantile(const uint32_t *v, uint32_t n, double q) {
+    uint32_t k = (uint32_t)(q * n + 0.999999);
+    return v[k ? k - 1 : 0];
+}
+
+// Сортує v на місці: сирі значення після звіту не потрібні
+static BalSummary_t Summarize(uint32_t *v, uint32_t n) {
+    BalSummary_t s = { 0 };
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) sum += v[i];
+    qsort(v, n, sizeof(v[0]), Cmp_U32);
+    s.mean = (double)sum / n;
+    s.p10 = Sorted_Quantile(v, n, 0.10);
+    s.p50 = Sorted_Quantile(v, n, 0.50);
+    s.p90 = Sorted_Quantile(v, n, 0.90);
+    s.p99 = Sorted_Quantile(v, n, 0.99);
+    s.max = v[n - 1];
+    return s;
+}
+
+static BalSummary_t Summarize_Hist(const uint64_t *h, int bins) {
+    BalSummary_t s = { 0 };
+    uint64_t total = 0, acc = 0;
+    double sum = 0.0;
+    for (int i = 0; i < bins; i++) {
+        total += h[i];
+        sum += (double)h[i] * i;
+        if (h[i]) s.max = (uint32_t)i;
+    }
+    if (!total) return s;
+    s.mean = sum / (double)total;
+    const double qs[4] = { 0.10, 0.50, 0.90, 0.99 };
+    uint32_t *out[4] = { &s.p10, &s.p50, &s.p90, &s.p99 };
+    int q = 0;
+    for (int i = 0; i < bins && q < 4; i++) {
+        acc += h[i];
+        while (q < 4 && (double)acc >= qs[q] * (double)total) *out[q++] = (uint32_t)i;
+    }
+    return s;
+}
+
+/* --- РОЗБІР АРГУМЕНТІВ --- */
+
+// "a,b,c" -> до max чисел; повертає їх кількість або -1
+static int Parse_List(const char *s, unsigned *out, int max) {
+    int n = 0;
+    for (;;) {
+        char *end;
+        unsigned long v = strtoul(s, &end, 0);
+        if (end == s || n == max || v > 0xFFFF) return -1;
+        out[n++] = (unsigned)v;
+        if (*end == '\0') return n;
+        if (*end != ',') return -1;
+        s = end + 1;
+    }
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--table A,B,C]... [--colors K,...] [--sizes RxC,...] [--games N] [--seed-base S]\n"
+                    "          [--threads T] [--policy " SIM_POLICY_NAMES "] [--max-moves M]\n"
+                    "          [--refill-no-match] [--csv | --json]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    uint16_t tables[BAL_MAX_LIST][GAME_SCORE_TABLE_SIZE];
+    unsigned colors[BAL_MAX_LIST] = { GAME_NUM_COLORS };
+    unsigned rows[BAL_MAX_LIST] = { BOARD_ROWS }, cols[BAL_MAX_LIST] = { BOARD_COLS };
+    int n_tables = 0, n_colors = 1, n_sizes = 1;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *policy_name = "greedy";
+    int csv = 0, json = 0;
+
+    pool.games = 10000;
+    pool.seed_base = 1;
+    pool.max_moves = 1000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--table") && i + 1 < argc) {
+            unsigned t[GAME_SCORE_TABLE_SIZE];
+            if (n_tables == BAL_MAX_LIST || Parse_List(argv[++i], t, GAME_SCORE_TABLE_SIZE) != GAME_SCORE_TABLE_SIZE) {
+                Usage(argv[0]);
+                return 2;
+            }
+            for (int k = 0; k < GAME_SCORE_TABLE_SIZE; k++) tables[n_tables][k] = (uint16_t)t[k];
+            n_tables++;
+        } else if (!strcmp(argv[i], "--colors") && i + 1 < argc) {
+            n_colors = Parse_List(argv[++i], colors, BAL_MAX_LIST);
+            if (n_colors < 1) {
+                Usage(argv[0]);
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            const char *s = argv[++i];
+            int consumed;
+            n_sizes = 0;
+            while (n_sizes < BAL_MAX_LIST && sscanf(s, "%ux%u%n", &rows[n_sizes], &cols[n_sizes], &consumed) == 2) {
+                n_sizes++;
+                s += consumed;
+                if (*s != ',') break;
+                s++;
+            }
+            if (n_sizes == 0 || *s != '\0') {
+                Usage(argv[0]);
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            pool.games = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed-base") && i + 1 < argc) {
+            pool.seed_base = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--policy") && i + 1 < argc) {
+            policy_name = argv[++i];
+        } else if (!strcmp(argv[i], "--max-moves") && i + 1 < argc) {
+            pool.max_moves = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--refill-no-match")) {
+            pool.refill_no_match = 1;
+        } else if (!strcmp(argv[i], "--csv")) {
+            csv = 1;
+        } else if (!strcmp(argv[i], "--json")) {
+            json = 1;
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (n_tables == 0) {
+        Game_t probe;
+        Game_Setup(&probe, NULL, NULL); // Типова таблиця рушія
+        memcpy(tables[0], probe.score_table, sizeof(tables[0]));
+        n_tables = 1;
+    }
+    pool.policy = Sim_FindPolicy(policy_name);
+    if (!pool.policy || threads < 1 || pool.games == 0 || pool.max_moves > BAL_MAX_MOVES || (csv && json) ||
+        (uint64_t)pool.seed_base + pool.games > 0xFFFFFFFFu) {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    // Сітка: розмір → кольори → таблиця, кожна комбінація перевіряється наперед
+    for (int s = 0; s < n_sizes; s++) {
+        for (int k = 0; k < n_colors; k++) {
+            Game_t probe;
+            Game_Setup(&probe, NULL, NULL);
+            if (rows[s] > 255 || cols[s] > 255 || colors[k] > 255 ||
+                !Game_SetGeometry(&probe, (uint8_t)rows[s], (uint8_t)cols[s], (uint8_t)colors[k])) {
+                fprintf(stderr, "%ux%u with %u colours is not supported by this build (max %dx%d, %d colours%s)\n",
+                        rows[s], cols[s], colors[k], BOARD_ROWS, BOARD_COLS, GAME_NUM_COLORS,
+                        GAME_RUNTIME_GEOMETRY ? "" : ", fixed geometry");
+                return 2;
+            }
+            for (int t = 0; t < n_tables; t++) {
+                BalConfig_t *c = &pool.configs[pool.count++];
+                memcpy(c->table, tables[t], sizeof(c->table));
+                c->rows = (uint8_t)rows[s];
+                c->cols = (uint8_t)cols[s];
+                c->colors = (uint8_t)colors[k];
+                c->score = malloc(sizeof(uint32_t) * pool.games);
+                c->length = malloc(sizeof(uint32_t) * pool.games);
+                if (!c->score || !c->length) {
+                    fprintf(stderr, "out of memory for %u games\n", pool.games);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    BalWorker_t *workers = aligned_alloc(BAL_CACHE_LINE, sizeof(BalWorker_t) * (size_t)threads);
+    for (int t = 0; t < threads; t++) workers[t].stats = calloc((size_t)pool.count, sizeof(BalStats_t));
+    atomic_init(&pool.next, 0);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int t = 0; t < threads; t++) pthread_create(&workers[t].thread, NULL, Bal_Worker, &workers[t]);
+    for (int t = 0; t < threads; t++) pthread_join(workers[t].thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    if (csv) {
+        printf("rows,cols,colors,score3,score4,score5,games,capped,"
+               "score_mean,score_p10,score_p50,score_p90,score_p99,score_max,"
+               "moves_mean,moves_p10,moves_p50,moves_p90,moves_p99,moves_max,"
+               "depth_mean,depth_p50,depth_p90,depth_p99,depth_max\n");
+    } else if (json) {
+        printf("{\n  \"policy\": \"%s\", \"games\": %u, \"seed_base\": %u, \"max_moves\": %u, \"refill_no_match\": %u,\n"
+               "  \"threads\": %d, \"seconds\": %.3f,\n  \"configs\": [\n",
+               policy_name, pool.games, pool.seed_base, pool.max_moves, pool.refill_no_match, threads, secs);
+    } else {
+        printf("policy %s, %u games per config (seeds %u..%u), %d configs on %d threads in %.2f s\n",
+               policy_name, pool.games, pool.seed_base, pool.seed_base + pool.games - 1, pool.count, threads, secs);
+        printf("size   col  table          capped  score mean    p10    p50    p90    p99"
+               "  moves mean   p10   p50   p90   p99  depth mean p90 p99\n");
+    }
+
+    // Злиття після join — на гарячому шляху потоки нічого спільного не пишуть
+    for (int i = 0; i < pool.count; i++) {
+        BalConfig_t *c = &pool.configs[i];
+        BalStats_t all = { 0 };
+        for (int t = 0; t < threads; t++) {
+            all.capped += workers[t].stats[i].capped;
+            for (int b = 0; b < BAL_DEPTH_BINS; b++) all.depth[b] += workers[t].stats[i].depth[b];
+        }
+        BalSummary_t sc = Summarize(c->score, pool.games);
+        BalSummary_t mv = Summarize(c->length, pool.games);
+        BalSummary_t dp = Summarize_Hist(all.depth, BAL_DEPTH_BINS);
+
+        if (csv) {
+            printf("%u,%u,%u,%u,%u,%u,%u,%llu,%.3f,%u,%u,%u,%u,%u,%.3f,%u,%u,%u,%u,%u,%.4f,%u,%u,%u,%u\n",
+                   c->rows, c->cols, c->colors, c->table[0], c->table[1], c->table[2], pool.games,
+                   (unsigned long long)all.capped, sc.mean, sc.p10, sc.p50, sc.p90, sc.p99, sc.max,
+                   mv.mean, mv.p10, mv.p50, mv.p90, mv.p99, mv.max, dp.mean, dp.p50, dp.p90, dp.p99, dp.max);
+        } else if (json) {
+            printf("    {\"rows\": %u, \"cols\": %u, \"colors\": %u, \"table\": [%u, %u, %u], \"capped\": %llu,\n"
+                   "     \"score\": {\"mean\": %.3f, \"p10\": %u, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"max\": %u},\n"
+                   "     \"moves\": {\"mean\": %.3f, \"p10\": %u, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"max\": %u},\n"
+                   "     \"cascade_depth\": {\"mean\": %.4f, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"max\": %u}}%s\n",
+                   c->rows, c->cols, c->colors, c->table[0], c->table[1], c->table[2], (unsigned long long)all.capped,
+                   sc.mean, sc.p10, sc.p50, sc.p90, sc.p99, sc.max, mv.mean, mv.p10, mv.p50, mv.p90, mv.p99, mv.max,
+                   dp.mean, dp.p50, dp.p90, dp.p99, dp.max, i + 1 < pool.count ? "," : "");
+        } else {
+            char size[16], table[24];
+            snprintf(size, sizeof(size), "%ux%u", c->rows, c->cols);
+            snprintf(table, sizeof(table), "%u/%u/%u", c->table[0], c->table[1], c->table[2]);
+            printf("%-6s %3u  %-13s %7llu %11.1f %6u %6u %6u %6u %11.1f %5u %5u %5u %5u %11.3f %3u %3u\n",
+                   size, c->colors, table, (unsigned long long)all.capped, sc.mean, sc.p10, sc.p50, sc.p90, sc.p99,
+                   mv.mean, mv.p10, mv.p50, mv.p90, mv.p99, dp.mean, dp.p90, dp.p99);
+        }
+        free(c->score);
+        free(c->length);
+    }
+    if (json) printf("  ]\n}\n");
+
+    for (int t = 0; t < threads; t++) free(workers[t].stats);
+    free(workers);
+    return 0;
+}
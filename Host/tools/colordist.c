@@ -0,0 +1,167 @@
+/* Перевірка генератора кольорів при заповненні поля (Game_Init, Game_Shuffle).
+ *   match3_colordist [--boards N] [--seed-base S]
+ * Для кожної клітинки відтворює множину заборонених кольорів (пари сусідів
+ * зліва та згори) і перевіряє, що:
+ *   - заборонений колір ніколи не випадає, ліній на полі немає, а хід є;
+ *   - на поле витрачається рівно BOARD_ROWS * BOARD_COLS викликів генератора
+ *     (удвічі більше, якщо поле без ходу перегенеровано);
+ *   - серед дозволених кольорів розподіл рівномірний (хі-квадрат, p = 0.001).
+ * Game_Shuffle викликається на кожному полі ще раз і перевіряється так само,
+ * окрім розподілу.
+ *   match3_colordist --refill-no-match [--boards N]
+ * N ігор по REFILL_MOVES випадкових ходів з Game_SetRefillNoMatch на полях з 3 і 4
+ * кольорами (tools/refill_variant.c): скільки дозаповнень поставили нову кульку в
+ * лінію. З 3 кольорами це можливо — друкується, скільки; з 4 — порушення.
+ * Код виходу 0 — усе гаразд, 1 — порушення. */
+#include "game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DIST_MASKS      (1u << (GAME_NUM_COLORS + 1))
+#define DIST_MIN_SAMPLES 1000 // Менші вибірки хі-квадрат не оцінює
+#define REFILL_MOVES     100
+
+// Варіанти tools/refill_variant.c, як у CMakeLists.txt: кількість кольорів і чи допустимі лінії
+#define REFILL_VARIANTS(X) \
+    X(refill3, 3, 1) \
+    X(refill4, 4, 0)
+
+#define REFILL_DECLARE(v, colors, lines_ok) uint64_t v##_refill_lines(uint32_t games, uint32_t moves, uint64_t *refills);
+REFILL_VARIANTS(REFILL_DECLARE)
+
+// Критичні значення хі-квадрат для p = 0.001, індекс — ступені свободи
+static const double kChi2Crit[] = { 0, 10.83, 13.82, 16.27, 18.47, 20.52, 22.46, 24.32 };
+
+static uint64_t counts[DIST_MASKS][GAME_NUM_COLORS + 1];
+
+// Стан генератора після Game_Init(seed) і n викликів — та сама арифметика, що в game.c
+static uint32_t Dist_ExpectedRng(uint32_t seed, int n) {
+    seed ^= seed >> 16; seed *= 0x85EBCA6Bu;
+    seed ^= seed >> 13; seed *= 0xC2B2AE35u;
+    seed ^= seed >> 16;
+    uint32_t x = seed ? seed : 0x9E3779B9u;
+    while (n--) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    return x;
+}
+
+// Під час заповнення праворуч і знизу ще порожньо: забороняють лише пари зліва та згори
+static uint32_t Dist_Forbidden(const Game_t *g, int r, int c) {
+    uint32_t f = 0;
+    if (c >= 2 && g->board[r][c-1] == g->board[r][c-2]) f |= 1u << g->board[r][c-1];
+    if (r >= 2 && g->board[r-1][c] == g->board[r-2][c]) f |= 1u << g->board[r-1][c];
+    return f;
+}
+
+// Дозаповнення з Game_SetRefillNoMatch; 1 — лінія там, де кольорів вистачає, щоб її уникнути
+static int Dist_RefillCheck(uint32_t games) {
+    int failed = 0;
+#define REFILL_RUN(v, colors, lines_ok) \
+    do { \
+        uint64_t refills, lines = v##_refill_lines(games, REFILL_MOVES, &refills); \
+        printf("refill-no-match, %d colours: %u games x %d moves, %llu refills, %llu put a new ball into a line%s\n", \
+               colors, games, REFILL_MOVES, (unsigned long long)refills, (unsigned long long)lines, \
+               lines && !(lines_ok) ? "  FAIL" : ""); \
+        if (lines && !(lines_ok)) failed = 1; \
+    } while (0);
+    REFILL_VARIANTS(REFILL_RUN)
+#undef REFILL_RUN
+    printf("%s\n", failed ? "FAIL" : "OK");
+    return failed;
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--boards N] [--seed-base S] [--refill-no-match]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    uint32_t boards = 0, seed_base = 1;
+    int refill = 0;
+    uint64_t bad_color = 0, bad_line = 0, bad_moves = 0, bad_rng = 0, reshuffled = 0;
+    const int cells = BOARD_ROWS * BOARD_COLS;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--boards") && i + 1 < argc) {
+            boards = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed-base") && i + 1 < argc) {
+            seed_base = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--refill-no-match")) {
+            refill = 1;
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (refill) return Dist_RefillCheck(boards ? boards : 2000);
+    if (!boards) boards = 200000;
+
+    Game_t g;
+    Game_Setup(&g, NULL, NULL);
+    for (uint32_t s = seed_base; s != seed_base + boards; s++) {
+        Game_Init(&g, s);
+        if (!Game_FindMoves(&g, NULL, 1)) bad_moves++;
+        if (Game_IsMatchPresent(&g)) bad_line++;
+        if (g.rng_state != Dist_ExpectedRng(s, cells)) {
+            // Перше поле вийшло без ходу; розподіл перегенерованого тут не рахуємо
+            if (g.rng_state == Dist_ExpectedRng(s, 2 * cells)) reshuffled++;
+            else bad_rng++;
+            continue;
+        }
+        for (int r = 0; r < BOARD_ROWS; r++) {
+            for (int c = 0; c < BOARD_COLS; c++) {
+                uint32_t f = Dist_Forbidden(&g, r, c) & ~1u;
+                uint8_t color = g.board[r][c];
+                if (color < 1 || color > GAME_NUM_COLORS || (f >> color) & 1u) bad_color++;
+                else counts[f][color]++;
+            }
+        }
+
+        uint32_t before = g.rng_state;
+        Game_Shuffle(&g);
+        if (!Game_FindMoves(&g, NULL, 1)) bad_moves++;
+        if (Game_IsMatchPresent(&g)) bad_line++;
+        for (int i = 0; i < cells; i++) {
+            before ^= before << 13;
+            before ^= before >> 17;
+            before ^= before << 5;
+        }
+        if (g.rng_state != before) bad_rng++;
+    }
+
+    int failed = bad_color || bad_line || bad_moves || bad_rng;
+    printf("%u boards (+%u shuffled): forbidden colour %llu, lines %llu, no move %llu, "
+           "wrong rng call count %llu; %llu initial boards had no move\n",
+           boards, boards, (unsigned long long)bad_color, (unsigned long long)bad_line,
+           (unsigned long long)bad_moves, (unsigned long long)bad_rng, (unsigned long long)reshuffled);
+    printf("forbidden  allowed     samples     chi2  crit\n");
+
+    for (uint32_t f = 0; f < DIST_MASKS; f += 2) {
+        uint64_t n = 0;
+        int allowed = 0;
+        for (int k = 1; k <= GAME_NUM_COLORS; k++) {
+            if ((f >> k) & 1u) continue;
+            n += counts[f][k];
+            allowed++;
+        }
+        if (n < DIST_MIN_SAMPLES || allowed < 2) continue;
+
+        double expected = (double)n / allowed, chi2 = 0;
+        for (int k = 1; k <= GAME_NUM_COLORS; k++) {
+            if ((f >> k) & 1u) continue;
+            double d = (double)counts[f][k] - expected;
+            chi2 += d * d / expected;
+        }
+        double crit = kChi2Crit[allowed - 1];
+        printf("0x%02x       %7d %11llu %8.2f %5.2f%s\n", f, allowed,
+               (unsigned long long)n, chi2, crit, chi2 > crit ? "  FAIL" : "");
+        if (chi2 > crit) failed = 1;
+    }
+
+    printf("%s\n", failed ? "FAIL" : "OK");
+    return failed;
+}
@@ -0,0 +1,173 @@
+/* Звірка варіантів збирання рушія (Host/variant) між собою.
+ *   match3_equiv [--games N] [--moves M] [--seed S]
+ * Кожна гра з тим самим зерном іде на всіх варіантах однаковими обмінами, поки не
+ * набереться M вдалих ходів: здебільшого хід з Game_FindMoves, інколи випадкова сусідня
+ * пара, що може бути відхилена. Перед кожним обміном збігаються списки ходів і
+ * Game_IsMatchPresent на полі після обміну (ще без згорання); після кожного кроку
+ * (обмін, кадр каскаду, перемішування в тупику) — поле, рахунок і Game_Fingerprint.
+ * Половина ігор — з Game_SetRefillNoMatch. Перший варіант — еталон.
+ * Код виходу 0 — усе збіглося, 1 — перша розбіжність (друкується, де саме). */
+#include "variant.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Той самий список, що й варіанти match3_equiv у CMakeLists.txt
+#define EQ_VARIANTS(X) \
+    X(eq_bitboard_full) \
+    X(eq_bitboard_incr) \
+    X(eq_array_full) \
+    X(eq_array_incr) \
+    X(eq_swar_full) \
+    X(eq_swar_incr)
+
+#define EQ_DECLARE(v) extern const EngineVariant_t v##_variant;
+EQ_VARIANTS(EQ_DECLARE)
+#define EQ_ENTRY(v) &v##_variant,
+static const EngineVariant_t *const variants[] = { EQ_VARIANTS(EQ_ENTRY) };
+#define EQ_COUNT ((int)(sizeof(variants) / sizeof(variants[0])))
+
+static VariantSnap_t steps[EQ_COUNT][VARIANT_MAX_STEPS];
+static VariantMove_t moves[EQ_COUNT][VARIANT_MAX_MOVES];
+
+static uint32_t Eq_Random(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+// Заголовок звіту про розбіжність між еталоном і варіантом k
+static void Eq_Report(int k, uint32_t seed, uint32_t move, const VariantMove_t *m, const char *what) {
+    printf("seed %u, move %u", seed, move);
+    if (m) printf(" (%u,%u)-(%u,%u)", m->r1, m->c1, m->r2, m->c2);
+    printf(", %s: %s/%s vs %s/%s\n", what, variants[0]->backend, variants[0]->incremental ? "incremental" : "full",
+           variants[k]->backend, variants[k]->incremental ? "incremental" : "full");
+}
+
+// 1 — знімки різні; друкує першу відмінність
+static int Eq_Diff(const VariantSnap_t *a, const VariantSnap_t *b, int k, uint32_t seed, uint32_t move,
+                   const VariantMove_t *m, int step) {
+    char what[32];
+    if (!memcmp(a->board, b->board, sizeof(a->board)) && a->score == b->score && a->fingerprint == b->fingerprint)
+        return 0;
+    snprintf(what, sizeof(what), "step %d", step);
+    Eq_Report(k, seed, move, m, what);
+    for (int r = 0; r < VARIANT_ROWS; r++) {
+        for (int c = 0; c < VARIANT_COLS; c++) {
+            if (a->board[r][c] != b->board[r][c]) {
+                printf("  board[%d][%d]: %u vs %u\n", r, c, a->board[r][c], b->board[r][c]);
+                r = VARIANT_ROWS;
+                break;
+            }
+        }
+    }
+    printf("  score %u vs %u, fingerprint %08x vs %08x\nFAIL\n", a->score, b->score, a->fingerprint,
+           b->fingerprint);
+    return 1;
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--games N] [--moves M] [--seed S]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    uint32_t games = 2000, max_moves = 200, rng = 1;
+    uint64_t swaps = 0, refused = 0, compared = 0, move_lists = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            games = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--moves") && i + 1 < argc) {
+            max_moves = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            rng = (uint32_t)strtoul(argv[++i], NULL, 0);
+            if (rng == 0) rng = 1;
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t gi = 0; gi < games; gi++) {
+        uint32_t seed = Eq_Random(&rng);
+        VariantSnap_t first, other;
+        variants[0]->init(seed, (uint8_t)(gi & 1));
+        variants[0]->snap(&first);
+        for (int k = 1; k < EQ_COUNT; k++) {
+            variants[k]->init(seed, (uint8_t)(gi & 1));
+            variants[k]->snap(&other);
+            if (Eq_Diff(&first, &other, k, seed, 0, NULL, 0)) return 1;
+        }
+
+        for (uint32_t move = 1; move <= max_moves;) {
+            // Списки ходів на сталому полі: ті самі ходи в тому самому порядку
+            uint16_t n_moves = variants[0]->find_moves(moves[0], VARIANT_MAX_MOVES);
+            for (int k = 1; k < EQ_COUNT; k++) {
+                uint16_t nk = variants[k]->find_moves(moves[k], VARIANT_MAX_MOVES);
+                if (nk != n_moves || memcmp(moves[0], moves[k], n_moves * sizeof(VariantMove_t))) {
+                    Eq_Report(k, seed, move, NULL, "move list");
+                    printf("  %u vs %u moves\nFAIL\n", n_moves, nk);
+                    return 1;
+                }
+            }
+            move_lists++;
+
+            VariantMove_t m;
+            uint32_t x = Eq_Random(&rng);
+            if (n_moves && (x & 3)) {
+                m = moves[0][(x >> 8) % n_moves];
+            } else {
+                m.r1 = (uint8_t)(x % VARIANT_ROWS);
+                m.c1 = (uint8_t)((x >> 8) % VARIANT_COLS);
+                m.r2 = m.r1;
+                m.c2 = m.c1;
+                if (x & 0x10000) {
+                    if (m.r1 + 1 < VARIANT_ROWS) m.r2++;
+                    else m.r2--;
+                } else {
+                    if (m.c1 + 1 < VARIANT_COLS) m.c2++;
+                    else m.c2--;
+                }
+            }
+
+            int match = variants[0]->match_after(&m);
+            for (int k = 1; k < EQ_COUNT; k++) {
+                int mk = variants[k]->match_after(&m);
+                if (mk != match) {
+                    Eq_Report(k, seed, move, &m, "match after swap");
+                    printf("  %d vs %d\nFAIL\n", match, mk);
+                    return 1;
+                }
+            }
+
+            uint16_t n = variants[0]->play(&m, steps[0], VARIANT_MAX_STEPS);
+            swaps++;
+            for (int k = 1; k < EQ_COUNT; k++) {
+                uint16_t nk = variants[k]->play(&m, steps[k], VARIANT_MAX_STEPS);
+                if (nk != n) {
+                    Eq_Report(k, seed, move, &m, "steps");
+                    printf("  %u vs %u\nFAIL\n", n, nk);
+                    return 1;
+                }
+                for (uint16_t s = 0; s < n; s++) {
+                    if (Eq_Diff(&steps[0][s], &steps[k][s], k, seed, move, &m, s + 1)) return 1;
+                }
+                // Відхилений обмін не дає кроків, але поле має лишитися тим самим
+                variants[0]->snap(&first);
+                variants[k]->snap(&other);
+                if (Eq_Diff(&first, &other, k, seed, move, &m, n + 1)) return 1;
+            }
+            compared += n;
+            if (n) move++;
+            else refused++;
+        }
+    }
+
+    printf("%u games x %u moves on %d variants: %llu swaps (%llu refused), %llu move lists, "
+           "%llu steps compared\nOK\n", games, max_moves, EQ_COUNT, (unsigned long long)swaps,
+           (unsigned long long)refused, (unsigned long long)move_lists, (unsigned long long)compared);
+    return 0;
+}
@@ -0,0 +1,140 @@
+/* Перевірка історії ходів (history.c, команди UNDO/REDO).
+ *   match3_history [--games N] [--seed-base S] [--moves M]
+ * Для кожного зерна грає до M випадкових ходів (разом з перемішуванням, як
+ * прошивка після тупика), запам'ятовуючи повний стан після кожного. Далі:
+ *   - UNDO до кінця історії: кожен крок повертає саме той стан, що був до ходу;
+ *   - REDO до кінця: стани знову збігаються, тобто UNDO∘REDO — тотожність;
+ *   - випадкова суміш UNDO/REDO, а з середини — той самий хід ще раз: генератор
+ *     відновлено, тож поле після ходу збігається із записаним.
+ * Стан — поле, рахунок, генератор і кількість ходів. Код виходу 0 — усе гаразд, 1 — порушення. */
+#include "game.h"
+#include "history.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HC_MAX_MOVES 512
+
+typedef struct {
+    uint8_t  board[BOARD_ROWS][BOARD_COLS];
+    uint32_t score;
+    uint32_t rng_state;
+    uint16_t moves; // Game_FindMoves: перевіряє, що маски бекенду відновлено разом з полем
+} HcState_t;
+
+static HcState_t states[HC_MAX_MOVES + 1];
+static GameMove_t played[HC_MAX_MOVES];
+static History_t history;
+
+static uint32_t Hc_Random(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+static void Hc_Capture(Game_t *g, HcState_t *st) {
+    memcpy(st->board, g->board, sizeof(st->board));
+    st->score = g->score;
+    st->rng_state = g->rng_state;
+    st->moves = Game_FindMoves(g, NULL, GAME_MAX_MOVES);
+}
+
+static int Hc_Same(Game_t *g, const HcState_t *st) {
+    HcState_t now;
+    Hc_Capture(g, &now);
+    return !memcmp(now.board, st->board, sizeof(now.board)) && now.score == st->score &&
+           now.rng_state == st->rng_state && now.moves == st->moves && !Game_IsMatchPresent(g);
+}
+
+// Хід так, як його робить прошивка на 0x11: обмін, каскад, перемішування в тупику
+static void Hc_Play(Game_t *g, const GameMove_t *mv) {
+    History_Begin(&history, g);
+    if (Game_Swap(g, mv->r1, mv->c1, mv->r2, mv->c2)) {
+        Game_RunGravityLoop(g);
+        if (!Game_FindMoves(g, NULL, 1)) Game_Shuffle(g);
+    }
+    History_Commit(&history, g);
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--games N] [--seed-base S] [--moves M]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    uint32_t games = 2000, seed_base = 1, max_moves = 200;
+    uint64_t total_moves = 0, undone = 0, bad_undo = 0, bad_redo = 0, bad_replay = 0, bad_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            games = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed-base") && i + 1 < argc) {
+            seed_base = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--moves") && i + 1 < argc) {
+            max_moves = (uint32_t)strtoul(argv[++i], NULL, 0);
+            if (max_moves > HC_MAX_MOVES) max_moves = HC_MAX_MOVES;
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    Game_t g;
+    Game_Setup(&g, NULL, NULL);
+    Game_SetStepFrames(&g, 0);
+    for (uint32_t s = seed_base; s != seed_base + games; s++) {
+        uint32_t rng = s * 2654435761u + 1u;
+        Game_Init(&g, s);
+        History_Clear(&history);
+        Hc_Capture(&g, &states[0]);
+
+        uint32_t n = 0;
+        while (n < max_moves) {
+            GameMove_t moves[GAME_MAX_MOVES];
+            uint16_t count = Game_FindMoves(&g, moves, GAME_MAX_MOVES);
+            played[n] = moves[Hc_Random(&rng) % count]; // Після перемішування хід є завжди
+            Hc_Play(&g, &played[n]);
+            Hc_Capture(&g, &states[++n]);
+        }
+        total_moves += n;
+
+        // Кільце тримає лише останні ходи; решта витіснена
+        uint32_t kept = history.undo_count;
+        if (kept > n) bad_count++;
+        uint32_t at = n;
+        while (History_Undo(&history, &g, NULL)) {
+            if (!Hc_Same(&g, &states[--at])) bad_undo++;
+        }
+        if (at != n - kept) bad_count++;
+        undone += kept;
+        while (History_Redo(&history, &g, NULL)) {
+            if (!Hc_Same(&g, &states[++at])) bad_redo++;
+        }
+        if (at != n) bad_count++;
+
+        // Випадкові UNDO/REDO, потім той самий хід замість скасованого
+        for (int i = 0; i < 64; i++) {
+            if (Hc_Random(&rng) & 1) {
+                if (History_Undo(&history, &g, NULL) && !Hc_Same(&g, &states[--at])) bad_undo++;
+            } else {
+                if (History_Redo(&history, &g, NULL) && !Hc_Same(&g, &states[++at])) bad_redo++;
+            }
+        }
+        if (at < n) {
+            Hc_Play(&g, &played[at]);
+            if (!Hc_Same(&g, &states[++at])) bad_replay++;
+            if (history.redo_count != 0) bad_count++; // Новий хід відкидає скасовані
+        }
+    }
+
+    int failed = bad_undo || bad_redo || bad_replay || bad_count;
+    printf("%u games, %llu moves, %llu undone (HISTORY_BYTES %d, %.1f moves kept on average): "
+           "undo mismatch %llu, redo mismatch %llu, replay mismatch %llu, bookkeeping %llu\n%s\n",
+           games, (unsigned long long)total_moves, (unsigned long long)undone, HISTORY_BYTES,
+           games ? (double)undone / games : 0.0, (unsigned long long)bad_undo,
+           (unsigned long long)bad_redo, (unsigned long long)bad_replay,
+           (unsigned long long)bad_count, failed ? "FAIL" : "OK");
+    return failed;
+}
@@ -0,0 +1,73 @@
+#include "policy.h"
+#include "search.h"
+#include <string.h>
+
+static uint32_t Sim_Random(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+// Перший хід в порядку обходу
+static uint8_t Policy_First(Game_t *g, uint32_t *rng, GameMove_t *out) {
+    (void)rng;
+    return Game_FindMoves(g, out, 1);
+}
+
+static uint8_t Policy_Random(Game_t *g, uint32_t *rng, GameMove_t *out) {
+    GameMove_t moves[GAME_MAX_MOVES];
+    uint16_t n = Game_FindMoves(g, moves, GAME_MAX_MOVES);
+    if (!n) return 0;
+    *out = moves[Sim_Random(rng) % n];
+    return 1;
+}
+
+// Найбільше очок за сам обмін (без гравітації: наступні кульки ще невідомі гравцеві)
+static uint8_t Policy_Greedy(Game_t *g, uint32_t *rng, GameMove_t *out) {
+    (void)rng;
+    GameMove_t moves[GAME_MAX_MOVES];
+    uint16_t n = Game_FindMoves(g, moves, GAME_MAX_MOVES);
+    if (!n) return 0;
+    uint32_t best = 0;
+    *out = moves[0];
+    for (uint16_t i = 0; i < n; i++) {
+        Game_t probe = *g;
+        probe.ui_update = NULL;
+        Game_Swap(&probe, moves[i].r1, moves[i].c1, moves[i].r2, moves[i].c2);
+        if (probe.score - g->score > best) {
+            best = probe.score - g->score;
+            *out = moves[i];
+        }
+    }
+    return 1;
+}
+
+// Expectimax глибини 1 на 4 вибірках поповнення — те саме, що підказка 0x17
+static uint8_t Policy_Search(Game_t *g, uint32_t *rng, GameMove_t *out) {
+    (void)rng;
+    static const SearchConfig_t cfg = { .max_depth = 1, .samples = 4 };
+    SearchMove_t best;
+    if (!Search_BestMoves(g, &cfg, &best, 1, NULL)) return 0;
+    *out = best.move;
+    return 1;
+}
+
+static const struct {
+    const char *name;
+    SimPolicy_t fn;
+} kPolicies[] = {
+    { "first",  Policy_First },
+    { "random", Policy_Random },
+    { "greedy", Policy_Greedy },
+    { "search", Policy_Search },
+};
+
+SimPolicy_t Sim_FindPolicy(const char *name) {
+    for (size_t i = 0; i < sizeof(kPolicies) / sizeof(kPolicies[0]); i++) {
+        if (!strcmp(name, kPolicies[i].name)) return kPolicies[i].fn;
+    }
+    return NULL;
+}
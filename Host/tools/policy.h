@@ -0,0 +1,15 @@
+#ifndef HOST_TOOLS_POLICY_H_
+#define HOST_TOOLS_POLICY_H_
+
+#include "game.h"
+
+/* Політики ходу для самогри (match3_selfplay, match3_balance).
+ * Повертає 0, якщо ходів немає. rng — приватний генератор потоку,
+ * щоб вибір ходу не зсував генератор рушія (поля однакові для всіх політик). */
+typedef uint8_t (*SimPolicy_t)(Game_t *g, uint32_t *rng, GameMove_t *out);
+
+#define SIM_POLICY_NAMES "first|random|greedy|search"
+
+SimPolicy_t Sim_FindPolicy(const char *name); // NULL — невідома назва
+
+#endif /* HOST_TOOLS_POLICY_H_ */
@@ -0,0 +1,64 @@
+/* Дозаповнення з Game_SetRefillNoMatch на полі з іншою кількістю кольорів, ніж
+ * у libmatch3: game.c зібраний окремо з GAME_NUM_COLORS з CMake під іменами з
+ * префіксом ENGINE_VARIANT (variant/engine_variant.h). Для match3_colordist. */
+#include "engine_variant.h"
+#include "../../MCU/Core/Src/game.c"
+
+static GameEvent_t refill_events[2 * GAME_MAX_STEP_EVENTS];
+static uint64_t refill_steps, refill_lines;
+
+// Чи лежить (r, c) у горизонтальній чи вертикальній лінії з трьох і більше
+static int Refill_InLine(const Game_t *g, int r, int c) {
+    uint8_t k = g->board[r][c];
+    int h = 1, v = 1;
+    for (int i = c - 1; i >= 0 && g->board[r][i] == k; i--) h++;
+    for (int i = c + 1; i < BOARD_COLS && g->board[r][i] == k; i++) h++;
+    for (int i = r - 1; i >= 0 && g->board[i][c] == k; i--) v++;
+    for (int i = r + 1; i < BOARD_ROWS && g->board[i][c] == k; i++) v++;
+    return h >= 3 || v >= 3;
+}
+
+// Без покрокових кадрів SPAWN пишеться на кінцеві місця, а колбек іде одразу після дозаповнення
+static void Refill_Step(Game_t *g, void *ctx) {
+    int spawned = 0, line = 0;
+    (void)ctx;
+    for (uint16_t i = 0; i < g->event_count; i++) {
+        const GameEvent_t *e = &g->events[i];
+        if (e->type != GAME_EV_SPAWN) continue;
+        spawned = 1;
+        if (Refill_InLine(g, e->a, e->b)) line = 1;
+    }
+    refill_steps += spawned;
+    refill_lines += line;
+    Game_ClearEvents(g);
+}
+
+// Ігри з випадковими ходами; повертає дозаповнення, після яких нова кулька стоїть у лінії
+uint64_t VARIANT_SYM(refill_lines)(uint32_t games, uint32_t moves, uint64_t *refills) {
+    static Game_t g;
+    uint32_t pick = 1;
+    refill_steps = 0;
+    refill_lines = 0;
+    Game_Setup(&g, Refill_Step, NULL);
+    Game_SetStepFrames(&g, 0);
+    Game_SetRefillNoMatch(&g, 1);
+    Game_SetEventLog(&g, refill_events, sizeof(refill_events) / sizeof(refill_events[0]));
+    for (uint32_t s = 1; s <= games; s++) {
+        Game_Init(&g, s);
+        for (uint32_t m = 0; m < moves; m++) {
+            GameMove_t list[GAME_MAX_MOVES];
+            uint16_t n = Game_FindMoves(&g, list, GAME_MAX_MOVES);
+            if (n == 0) {
+                Game_Shuffle(&g);
+                continue;
+            }
+            pick = pick * 1103515245u + 12345u;
+            const GameMove_t *mv = &list[(pick >> 16) % n];
+            Game_Swap(&g, mv->r1, mv->c1, mv->r2, mv->c2);
+            Game_ClearEvents(&g);
+            Game_RunGravityLoop(&g);
+        }
+    }
+    *refills = refill_steps;
+    return refill_lines;
+}
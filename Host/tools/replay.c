@@ -0,0 +1,437 @@
+/* Перевірка записів гри (replay.h) для аудиту таблиці рекордів.
+ *   match3_replay [--threads T] [--quiet] FILE|DIR...
+ *   match3_replay --generate DIR [--games N] [--moves M] [--seed-base S]
+ *                 [--policy first|random|greedy|search] [--undo-pct P] [--threads T]
+ * Перевірка: кожен запис відтворюється з зерна через game.c так само, як прошивка
+ * обробляє 0x11/0x18/0x1A/0x1B, і кінцеві рахунок та Game_Fingerprint звіряються із
+ * заявленими в заголовку. Рядок на файл: OK / MISMATCH / ERROR (зіпсований файл,
+ * неможлива дія) / SKIP (обрізаний запис, гра зі слота, інша версія рушія чи
+ * геометрія, якої немає у збірці). Код виходу 0 — лише якщо всі файли OK.
+ * Файли розподіляються між потоками через атомарний лічильник, результати
+ * друкуються в порядку аргументів.
+ * --generate пише N записів самогри (з UNDO/REDO з імовірністю P%) — для перевірки
+ * самого верифікатора й замірів швидкості. Каталог DIR створюється, якщо його немає
+ * (лише останній рівень, як mkdir). */
+#include "game.h"
+#include "history.h"
+#include "replay.h"
+#include "policy.h"
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RP_MAX_THREADS 256
+
+typedef enum { RP_OK = 0, RP_MISMATCH, RP_ERROR, RP_SKIP } RpStatus_t;
+
+static const char *const rp_status_names[] = { "OK", "MISMATCH", "ERROR", "SKIP" };
+
+typedef struct {
+    RpStatus_t status;
+    ReplayHeader_t hdr;
+    uint32_t score;
+    uint32_t fingerprint;
+    uint64_t hash;
+    uint32_t actions;   // Скільки дій відтворено
+    char why[96];
+} RpResult_t;
+
+static struct {
+    char **paths;
+    RpResult_t *results;
+    uint32_t count;
+    atomic_uint next;
+
+    // --generate
+    const char *dir;
+    uint32_t games, moves, seed_base, undo_pct;
+    SimPolicy_t policy;
+} pool;
+
+static double Now_Sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint8_t *Read_File(const char *path, uint32_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = (n >= 0 && n < 0x7FFFFFFF) ? malloc(n ? (size_t)n : 1) : NULL;
+    if (data && fread(data, 1, (size_t)n, f) != (size_t)n) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *len = (uint32_t)n;
+    return data;
+}
+
+/* --- ВІДТВОРЕННЯ --- */
+
+// Хід так, як його виконує прошивка (0x11): обмін, каскад, у тупику — перемішування
+static uint8_t Rp_Swap(Game_t *g, const GameMove_t *m) {
+    if (!Game_Swap(g, m->r1, m->c1, m->r2, m->c2)) return 0;
+    Game_RunGravityLoop(g);
+    if (!Game_FindMoves(g, NULL, 1)) Game_Shuffle(g);
+    return 1;
+}
+
+static void Rp_Verify(const uint8_t *data, uint32_t len, History_t *hist, RpResult_t *res) {
+    ReplayHeader_t *h = &res->hdr;
+    uint32_t pos = REPLAY_HEADER_BYTES, code, n = 0;
+    uint8_t need_history = 0;
+    Game_t g;
+
+    res->status = RP_ERROR;
+    if (!Replay_ReadHeader(data, len, h)) {
+        snprintf(res->why, sizeof(res->why), "not a replay file");
+        return;
+    }
+    if (h->format != REPLAY_FORMAT_VERSION) {
+        snprintf(res->why, sizeof(res->why), "format %u, expected %u", h->format, REPLAY_FORMAT_VERSION);
+        return;
+    }
+
+    // Спершу весь список дій: битий файл не доходить до рушія, а без UNDO/REDO не потрібна історія
+    while (pos < len) {
+        if (!Replay_NextCode(data, len, &pos, &code)) {
+            snprintf(res->why, sizeof(res->why), "truncated action %u", n);
+            return;
+        }
+        if (code == REPLAY_OP_UNDO || code == REPLAY_OP_REDO) need_history = 1;
+        n++;
+    }
+    if (n != h->count) {
+        snprintf(res->why, sizeof(res->why), "%u actions, header says %u", n, h->count);
+        return;
+    }
+
+    res->status = RP_SKIP;
+    if (h->flags & REPLAY_FLAG_TRUNCATED) {
+        snprintf(res->why, sizeof(res->why), "recording truncated on the device");
+        return;
+    }
+    if (h->flags & REPLAY_FLAG_LOADED) {
+        snprintf(res->why, sizeof(res->why), "game continued from a save slot");
+        return;
+    }
+    if (h->engine != GAME_ENGINE_VERSION) {
+        snprintf(res->why, sizeof(res->why), "engine %u, this build is %u", h->engine, GAME_ENGINE_VERSION);
+        return;
+    }
+
+    Game_Setup(&g, NULL, NULL);
+    Game_SetStepFrames(&g, 0);
+    if (!Game_SetGeometry(&g, h->rows, h->cols, h->colors)) {
+        snprintf(res->why, sizeof(res->why), "%ux%u/%u not supported by this build", h->rows, h->cols, h->colors);
+        return;
+    }
+    Game_Init(&g, h->seed);
+    History_Clear(hist);
+
+    res->status = RP_ERROR;
+    pos = REPLAY_HEADER_BYTES;
+    for (n = 0; n < h->count; n++) {
+        GameMove_t m = { 0 };
+        uint8_t ok;
+        Replay_NextCode(data, len, &pos, &code);
+        if (code >= REPLAY_OP_SWAP) {
+            if (!Replay_DecodeSwap(h->rows, h->cols, code, &m)) {
+                snprintf(res->why, sizeof(res->why), "action %u: bad swap code %u", n, code);
+                break;
+            }
+            if (need_history) History_Begin(hist, &g);
+            ok = Rp_Swap(&g, &m);
+            if (need_history) History_Commit(hist, &g);
+        } else if (code == REPLAY_OP_SHUFFLE) {
+            if (need_history) History_Begin(hist, &g);
+            Game_Shuffle(&g);
+            if (need_history) History_Commit(hist, &g);
+            ok = 1;
+        } else {
+            ok = (code == REPLAY_OP_UNDO) ? History_Undo(hist, &g, NULL) : History_Redo(hist, &g, NULL);
+        }
+        if (!ok) {
+            if (code >= REPLAY_OP_SWAP) {
+                snprintf(res->why, sizeof(res->why), "action %u: swap (%u,%u)-(%u,%u) makes no line",
+                         n, m.r1, m.c1, m.r2, m.c2);
+            } else {
+                snprintf(res->why, sizeof(res->why), "action %u: nothing to %s", n,
+                         code == REPLAY_OP_UNDO ? "undo" : "redo");
+            }
+            break;
+        }
+    }
+
+    res->actions = n;
+    res->score = g.score;
+    res->fingerprint = Game_Fingerprint(&g);
+    res->hash = g.hash;
+    if (n < h->count) return;
+    if (res->score != h->score || res->fingerprint != h->fingerprint) {
+        res->status = RP_MISMATCH;
+        snprintf(res->why, sizeof(res->why), "claimed score %u fp %08x", h->score, h->fingerprint);
+        return;
+    }
+    res->status = RP_OK;
+}
+
+static void *Rp_VerifyWorker(void *arg) {
+    History_t *hist = malloc(sizeof(History_t));
+    (void)arg;
+    if (!hist) return NULL;
+    for (;;) {
+        unsigned i = atomic_fetch_add(&pool.next, 1);
+        if (i >= pool.count) break;
+        RpResult_t *res = &pool.results[i];
+        uint32_t len;
+        uint8_t *data = Read_File(pool.paths[i], &len);
+        if (!data) {
+            res->status = RP_ERROR;
+            snprintf(res->why, sizeof(res->why), "cannot read");
+            continue;
+        }
+        Rp_Verify(data, len, hist, res);
+        free(data);
+    }
+    free(hist);
+    return NULL;
+}
+
+/* --- ГЕНЕРАЦІЯ --- */
+
+static uint32_t Rp_Next(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+static int Rp_Generate(uint32_t idx, Replay_t *rep, History_t *hist) {
+    Game_t g;
+    GameMove_t m;
+    uint32_t seed = pool.seed_base + idx;
+    uint32_t rng = seed * 0x9E3779B9u + 1;
+    uint8_t header[REPLAY_HEADER_BYTES];
+    char path[4096];
+
+    Game_Setup(&g, NULL, NULL);
+    Game_SetStepFrames(&g, 0);
+    Game_Init(&g, seed);
+    History_Clear(hist);
+    Replay_Clear(rep, 0);
+
+    for (uint32_t k = 0; k < pool.moves; k++) {
+        if (Rp_Next(&rng) % 100 < pool.undo_pct) {
+            uint8_t redo = Rp_Next(&rng) & 1;
+            if (redo ? History_Redo(hist, &g, NULL) : History_Undo(hist, &g, NULL)) {
+                Replay_RecordOp(rep, redo ? REPLAY_OP_REDO : REPLAY_OP_UNDO);
+            }
+            continue;
+        }
+        if (!pool.policy(&g, &rng, &m)) break; // Після Rp_Swap хід є завжди
+        History_Begin(hist, &g);
+        Rp_Swap(&g, &m);
+        History_Commit(hist, &g);
+        Replay_RecordSwap(rep, &g, m.r1, m.c1, m.r2, m.c2);
+    }
+
+    Replay_WriteHeader(rep, &g, header);
+    snprintf(path, sizeof(path), "%s/game_%06u.m3r", pool.dir, idx);
+    FILE *f = fopen(path, "wb");
+    if (!f) return 0;
+    int ok = fwrite(header, 1, sizeof(header), f) == sizeof(header) &&
+             fwrite(rep->buf, 1, rep->len, f) == rep->len;
+    return fclose(f) == 0 && ok;
+}
+
+static void *Rp_GenerateWorker(void *arg) {
+    Replay_t *rep = malloc(sizeof(Replay_t));
+    History_t *hist = malloc(sizeof(History_t));
+    atomic_int *failed = arg;
+    if (rep && hist) {
+        for (;;) {
+            unsigned i = atomic_fetch_add(&pool.next, 1);
+            if (i >= pool.games) break;
+            if (!Rp_Generate(i, rep, hist)) atomic_store(failed, 1);
+        }
+    } else {
+        atomic_store(failed, 1);
+    }
+    free(rep);
+    free(hist);
+    return NULL;
+}
+
+/* --- РОЗБІР АРГУМЕНТІВ --- */
+
+static int Cmp_Str(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int Push_Path(char *path, char ***paths, uint32_t *count, uint32_t *cap) {
+    if (!path) return -1;
+    if (*count == *cap) {
+        uint32_t n = *cap ? *cap * 2 : 256;
+        char **p = realloc(*paths, n * sizeof(char *));
+        if (!p) return -1;
+        *paths = p;
+        *cap = n;
+    }
+    (*paths)[(*count)++] = path;
+    return 0;
+}
+
+// Каталог розгортається в усі *.m3r у ньому (за абеткою), решта береться як файл
+static int Add_Path(const char *arg, char ***paths, uint32_t *count, uint32_t *cap) {
+    DIR *d = opendir(arg);
+    uint32_t first = *count;
+    struct dirent *e;
+
+    if (!d) return Push_Path(strdup(arg), paths, count, cap);
+    while ((e = readdir(d)) != NULL) {
+        size_t n = strlen(e->d_name);
+        if (n < 4 || strcmp(e->d_name + n - 4, ".m3r") != 0) continue;
+        char *full = malloc(strlen(arg) + n + 2);
+        if (full) sprintf(full, "%s/%s", arg, e->d_name);
+        if (Push_Path(full, paths, count, cap) != 0) {
+            closedir(d);
+            return -1;
+        }
+    }
+    closedir(d);
+    qsort(*paths + first, *count - first, sizeof(char *), Cmp_Str);
+    return 0;
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--threads T] [--quiet] FILE|DIR...\n"
+                    "       %s --generate DIR [--games N] [--moves M] [--seed-base S]\n"
+                    "          [--policy " SIM_POLICY_NAMES "] [--undo-pct P] [--threads T]\n", argv0, argv0);
+}
+
+static int Run_Threads(int threads, void *(*fn)(void *), void *arg) {
+    pthread_t tid[RP_MAX_THREADS];
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tid[t], NULL, fn, arg) != 0) break;
+        started++;
+    }
+    fn(arg); // Викликач — теж робочий потік
+    for (int t = 1; t <= started; t++) pthread_join(tid[t], NULL);
+    return started + 1;
+}
+
+int main(int argc, char **argv) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN), quiet = 0;
+    const char *policy_name = "greedy";
+    uint32_t cap = 0;
+
+    pool.games = 1000;
+    pool.moves = 500;
+    pool.seed_base = 1;
+    pool.undo_pct = 5;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--quiet")) {
+            quiet = 1;
+        } else if (!strcmp(argv[i], "--generate") && i + 1 < argc) {
+            pool.dir = argv[++i];
+        } else if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            pool.games = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--moves") && i + 1 < argc) {
+            pool.moves = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed-base") && i + 1 < argc) {
+            pool.seed_base = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--policy") && i + 1 < argc) {
+            policy_name = argv[++i];
+        } else if (!strcmp(argv[i], "--undo-pct") && i + 1 < argc) {
+            pool.undo_pct = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (argv[i][0] != '-' && !pool.dir) {
+            if (Add_Path(argv[i], &pool.paths, &pool.count, &cap) != 0) {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (threads > RP_MAX_THREADS) threads = RP_MAX_THREADS;
+    atomic_init(&pool.next, 0);
+
+    if (pool.dir) {
+        atomic_int failed;
+        pool.policy = Sim_FindPolicy(policy_name);
+        if (!pool.policy || pool.undo_pct > 100) {
+            Usage(argv[0]);
+            return 2;
+        }
+        if (mkdir(pool.dir, 0777) != 0 && errno != EEXIST) {
+            fprintf(stderr, "cannot create %s: %s\n", pool.dir, strerror(errno));
+            return 1;
+        }
+        atomic_init(&failed, 0);
+        double t0 = Now_Sec();
+        Run_Threads(threads, Rp_GenerateWorker, &failed);
+        if (atomic_load(&failed)) {
+            fprintf(stderr, "cannot write replays to %s\n", pool.dir);
+            return 1;
+        }
+        fprintf(stderr, "%u replays written to %s in %.3f s\n", pool.games, pool.dir, Now_Sec() - t0);
+        return 0;
+    }
+
+    if (!pool.count) {
+        Usage(argv[0]);
+        return 2;
+    }
+    pool.results = calloc(pool.count, sizeof(RpResult_t));
+    if (!pool.results) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    double t0 = Now_Sec();
+    int used = Run_Threads(threads < (int)pool.count ? threads : (int)pool.count, Rp_VerifyWorker, NULL);
+    double sec = Now_Sec() - t0;
+
+    uint32_t by_status[4] = { 0 };
+    uint64_t actions = 0;
+    for (uint32_t i = 0; i < pool.count; i++) {
+        const RpResult_t *r = &pool.results[i];
+        by_status[r->status]++;
+        actions += r->actions;
+        if (quiet && r->status == RP_OK) continue;
+        printf("%s: %s", pool.paths[i], rp_status_names[r->status]);
+        if (r->status == RP_OK || r->status == RP_MISMATCH || (r->status == RP_ERROR && r->actions)) {
+            printf(" score %u fp %08x hash %016llx actions %u", r->score, r->fingerprint,
+                   (unsigned long long)r->hash, r->actions);
+        }
+        if (r->why[0]) printf(" (%s)", r->why);
+        printf("\n");
+    }
+    fprintf(stderr, "%u files: %u ok, %u mismatch, %u error, %u skipped; %llu actions in %.3f s "
+                    "(%.2f M actions/s, %d threads)\n",
+            pool.count, by_status[RP_OK], by_status[RP_MISMATCH], by_status[RP_ERROR], by_status[RP_SKIP],
+            (unsigned long long)actions, sec, sec > 0 ? actions / sec / 1e6 : 0.0, used);
+
+    for (uint32_t i = 0; i < pool.count; i++) free(pool.paths[i]);
+    free(pool.paths);
+    free(pool.results);
+    return by_status[RP_OK] == pool.count ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+/* Пошук найкращого ходу з командного рядка (search.c + паралельний корінь).
+ *   match3_search [--seed S] [--depth D] [--samples N] [--budget-us U] [--threads T]
+ *                 [--top K] [--tt-mb M] [--play M]
+ * Без --play: поле з Game_Init(S), до K найкращих ходів з очікуваними очками,
+ * досягнута глибина, вузли й час. З --play: ІІ робить M ходів підряд (у тупику —
+ * Game_Shuffle, як прошивка) і друкує рахунок та середній час на хід. */
+#include "game.h"
+#include "search_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--seed S] [--depth D] [--samples N] [--budget-us U] [--threads T]\n"
+                    "          [--top K] [--tt-mb M] [--play M]\n", argv0);
+}
+
+static void Print_Board(const Game_t *g) {
+    for (int r = 0; r < GAME_ROWS(g); r++) {
+        for (int c = 0; c < GAME_COLS(g); c++) printf("%c", g->board[r][c] ? '0' + g->board[r][c] : '.');
+        printf("\n");
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t seed = 1, budget_us = 0, play = 0;
+    int depth = 3, samples = 4, threads = (int)sysconf(_SC_NPROCESSORS_ONLN), top = 5, tt_mb = 64;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--depth") && i + 1 < argc) {
+            depth = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--samples") && i + 1 < argc) {
+            samples = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--budget-us") && i + 1 < argc) {
+            budget_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--top") && i + 1 < argc) {
+            top = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--tt-mb") && i + 1 < argc) {
+            tt_mb = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--play") && i + 1 < argc) {
+            play = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (depth < 1 || depth > 255 || samples < 1 || samples > 255 || top < 1 || tt_mb < 0) {
+        Usage(argv[0]);
+        return 2;
+    }
+    if (threads < 1) threads = 1;
+    if (top > GAME_MAX_MOVES) top = GAME_MAX_MOVES;
+
+    SearchConfig_t cfg = { .max_depth = (uint8_t)depth, .samples = (uint8_t)samples,
+                           .budget_us = budget_us, .now_us = SearchHost_NowUs };
+    TransTable_t tt = { 0 };
+    if (tt_mb > 0) {
+        if (TransTable_Alloc(&tt, (size_t)tt_mb << 20) != 0) {
+            fprintf(stderr, "cannot allocate %d MB transposition table\n", tt_mb);
+            return 1;
+        }
+        SearchHost_AttachTable(&cfg, &tt);
+    }
+
+    Game_t g;
+    Game_Setup(&g, NULL, NULL);
+    Game_SetStepFrames(&g, 0);
+    Game_Init(&g, seed);
+    SearchMove_t best[GAME_MAX_MOVES];
+    SearchStats_t st;
+
+    if (!play) {
+        Print_Board(&g);
+        uint32_t t0 = SearchHost_NowUs();
+        uint16_t n = SearchHost_BestMoves(&g, &cfg, threads, best, (uint16_t)top, &st);
+        uint32_t us = SearchHost_NowUs() - t0;
+        for (uint16_t i = 0; i < n; i++) {
+            printf("(%u,%u) <-> (%u,%u)  expected %.2f\n", best[i].move.r1, best[i].move.c1,
+                   best[i].move.r2, best[i].move.c2, (double)best[i].value / SEARCH_SCALE);
+        }
+        printf("depth %u of %d, %u nodes, %.3f ms, %d threads\n", st.depth, depth, st.nodes, us / 1000.0, threads);
+    } else {
+        uint64_t total_us = 0, total_nodes = 0;
+        uint32_t shuffles = 0;
+        for (uint32_t m = 0; m < play; m++) {
+            uint32_t t0 = SearchHost_NowUs();
+            SearchHost_BestMoves(&g, &cfg, threads, best, 1, &st);
+            total_us += SearchHost_NowUs() - t0;
+            total_nodes += st.nodes;
+            Game_Swap(&g, best[0].move.r1, best[0].move.c1, best[0].move.r2, best[0].move.c2);
+            Game_RunGravityLoop(&g);
+            if (!Game_FindMoves(&g, NULL, 1)) {
+                Game_Shuffle(&g);
+                shuffles++;
+            }
+        }
+        printf("%u moves: score %u, %u shuffles, %.3f ms and %llu nodes per move\n", play, g.score, shuffles,
+               total_us / 1000.0 / play, (unsigned long long)(total_nodes / play));
+    }
+
+    TransTable_Free(&tt);
+    return 0;
+}
@@ -0,0 +1,303 @@
+/* Пакетна самогра: рушій game.c грає сам із собою на N зернах у всіх ядрах.
+ *   match3_selfplay [--games N] [--seed-base S] [--threads T] [--policy first|random|greedy|search]
+ *                   [--max-moves M] [--refill-no-match] [--size RxC] [--colors K] [--json]
+ * Збирає розподіли довжини гри, глибини каскаду та фінального рахунку.
+ * Інші розміри поля й кількість кольорів — лише у збірці з GAME_RUNTIME_GEOMETRY.
+ *
+ * Потоки беруть зерна з власного діапазону порціями; хто свій вичерпав —
+ * забирає половину залишку в іншого (work stealing). Діапазон [begin, end)
+ * упакований в один 64-бітний атомік, тож і взяття, і крадіжка — один CAS.
+ * Гістограми в кожного потоку свої й зливаються лише після join. */
+#define _GNU_SOURCE
+#include "game.h"
+#include "policy.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIM_CHUNK        64    // Зерен за одне взяття з власного діапазону
+#define SIM_MAX_MOVES    4096  // Верхня межа --max-moves (розмір гістограми довжини)
+#define SIM_SCORE_BIN    100   // Ширина кошика гістограми рахунку
+#define SIM_SCORE_BINS   4096
+#define SIM_DEPTH_BINS   64
+#define SIM_CACHE_LINE   64
+
+/* --- СТАТИСТИКА --- */
+
+typedef struct {
+    uint64_t games;
+    uint64_t capped;   // Ігри, обірвані на --max-moves
+    uint64_t moves;
+    uint64_t length[SIM_MAX_MOVES + 1];
+    uint64_t depth[SIM_DEPTH_BINS];  // Глибина каскаду на кожен хід (0 — без комбо)
+    uint64_t score[SIM_SCORE_BINS];
+} __attribute__((aligned(SIM_CACHE_LINE))) SimStats_t; // Кожен потік пише лише у свою копію
+
+typedef struct {
+    _Atomic uint64_t range;  // (end << 32) | begin
+    SimStats_t *stats;
+    pthread_t thread;
+} __attribute__((aligned(SIM_CACHE_LINE))) SimWorker_t;
+
+typedef struct {
+    SimWorker_t *workers;
+    int count;
+    SimPolicy_t policy;
+    uint32_t max_moves;
+    uint8_t refill_no_match;
+    uint8_t rows, cols, colors;
+} SimPool_t;
+
+static SimPool_t pool;
+
+#define RANGE_PACK(b, e) (((uint64_t)(e) << 32) | (uint32_t)(b))
+#define RANGE_BEGIN(v)   ((uint32_t)(v))
+#define RANGE_END(v)     ((uint32_t)((v) >> 32))
+
+// Порція з початку власного діапазону
+static int Pool_Take(SimWorker_t *w, uint32_t *b, uint32_t *e) {
+    uint64_t cur = atomic_load(&w->range);
+    for (;;) {
+        uint32_t begin = RANGE_BEGIN(cur), end = RANGE_END(cur);
+        if (begin >= end) return 0;
+        uint32_t n = end - begin < SIM_CHUNK ? end - begin : SIM_CHUNK;
+        if (atomic_compare_exchange_weak(&w->range, &cur, RANGE_PACK(begin + n, end))) {
+            *b = begin;
+            *e = begin + n;
+            return 1;
+        }
+    }
+}
+
+// Половина залишку з кінця чужого діапазону стає власним діапазоном злодія
+static int Pool_Steal(SimWorker_t *self) {
+    int idx = (int)(self - pool.workers);
+    for (int i = 1; i < pool.count; i++) {
+        SimWorker_t *v = &pool.workers[(idx + i) % pool.count];
+        uint64_t cur = atomic_load(&v->range);
+        for (;;) {
+            uint32_t begin = RANGE_BEGIN(cur), end = RANGE_END(cur);
+            if (begin >= end) break;
+            uint32_t take = (end - begin + 1) / 2;
+            if (atomic_compare_exchange_weak(&v->range, &cur, RANGE_PACK(begin, end - take))) {
+                atomic_store(&self->range, RANGE_PACK(end - take, end));
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void Sim_CountStep(Game_t *g, void *ctx) {
+    (void)g;
+    (*(uint32_t *)ctx)++;
+}
+
+static void Sim_PlayGame(uint32_t seed, SimStats_t *st) {
+    Game_t g;
+    uint32_t steps;
+    uint32_t rng = seed * 0x9E3779B9u + 1;
+    uint32_t moves = 0;
+    GameMove_t m;
+
+    /* Без покрокових кадрів колбек викликається раз на падіння і раз на кожне
+     * згорання комбо: кроків = 2 * глибина + 1. */
+    Game_Setup(&g, Sim_CountStep, &steps);
+    Game_SetStepFrames(&g, 0);
+    Game_SetRefillNoMatch(&g, pool.refill_no_match);
+    Game_SetGeometry(&g, pool.rows, pool.cols, pool.colors); // Перевірено в main
+    Game_Init(&g, seed);
+
+    while (moves < pool.max_moves && pool.policy(&g, &rng, &m)) {
+        Game_Swap(&g, m.r1, m.c1, m.r2, m.c2);
+        steps = 0;
+        Game_RunGravityLoop(&g);
+        uint32_t depth = (steps - 1) / 2;
+        st->depth[depth < SIM_DEPTH_BINS ? depth : SIM_DEPTH_BINS - 1]++;
+        moves++;
+    }
+    if (moves == pool.max_moves && Game_HasPossibleMoves(&g)) st->capped++;
+
+    uint32_t bin = g.score / SIM_SCORE_BIN;
+    st->score[bin < SIM_SCORE_BINS ? bin : SIM_SCORE_BINS - 1]++;
+    st->length[moves]++;
+    st->moves += moves;
+    st->games++;
+}
+
+static void *Sim_Worker(void *arg) {
+    SimWorker_t *w = arg;
+    uint32_t b, e;
+    for (;;) {
+        while (Pool_Take(w, &b, &e)) {
+            for (uint32_t s = b; s < e; s++) Sim_PlayGame(s, w->stats);
+        }
+        if (!Pool_Steal(w)) break;
+    }
+    return NULL;
+}
+
+/* --- ЗВІТ --- */
+
+static uint64_t Hist_Total(const uint64_t *h, int n) {
+    uint64_t t = 0;
+    for (int i = 0; i < n; i++) t += h[i];
+    return t;
+}
+
+// Найменший кошик, до якого включно набирається частка q усіх значень
+static int Hist_Quantile(const uint64_t *h, int n, double q) {
+    uint64_t total = Hist_Total(h, n), acc = 0;
+    if (!total) return 0;
+    for (int i = 0; i < n; i++) {
+        acc += h[i];
+        if ((double)acc >= q * (double)total) return i;
+    }
+    return n - 1;
+}
+
+static double Hist_Mean(const uint64_t *h, int n, double scale) {
+    uint64_t total = Hist_Total(h, n);
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += (double)h[i] * i * scale;
+    return total ? sum / (double)total : 0.0;
+}
+
+static int Hist_Max(const uint64_t *h, int n) {
+    for (int i = n - 1; i >= 0; i--) {
+        if (h[i]) return i;
+    }
+    return 0;
+}
+
+static void Report_Text(const char *name, const uint64_t *h, int n, int scale) {
+    printf("%-14s mean %9.2f  p50 %6d  p90 %6d  p99 %6d  max %6d\n", name, Hist_Mean(h, n, scale),
+           Hist_Quantile(h, n, 0.50) * scale, Hist_Quantile(h, n, 0.90) * scale,
+           Hist_Quantile(h, n, 0.99) * scale, Hist_Max(h, n) * scale);
+}
+
+static void Report_Json(const char *name, const uint64_t *h, int n, int scale, int last) {
+    int top = Hist_Max(h, n);
+    printf("  \"%s\": {\"bin\": %d, \"mean\": %.3f, \"p50\": %d, \"p90\": %d, \"p99\": %d, \"max\": %d, \"hist\": [",
+           name, scale, Hist_Mean(h, n, scale), Hist_Quantile(h, n, 0.50) * scale,
+           Hist_Quantile(h, n, 0.90) * scale, Hist_Quantile(h, n, 0.99) * scale, top * scale);
+    for (int i = 0; i <= top; i++) printf("%s%llu", i ? ", " : "", (unsigned long long)h[i]);
+    printf("]}%s\n", last ? "" : ",");
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--games N] [--seed-base S] [--threads T] [--policy " SIM_POLICY_NAMES "]\n"
+                    "          [--max-moves M] [--refill-no-match] [--size RxC] [--colors K] [--json]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    uint32_t games = 100000, seed_base = 1;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *policy_name = "first";
+    int json = 0;
+
+    pool.max_moves = 1000;
+    pool.rows = BOARD_ROWS;
+    pool.cols = BOARD_COLS;
+    pool.colors = GAME_NUM_COLORS;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            games = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed-base") && i + 1 < argc) {
+            seed_base = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--policy") && i + 1 < argc) {
+            policy_name = argv[++i];
+        } else if (!strcmp(argv[i], "--max-moves") && i + 1 < argc) {
+            pool.max_moves = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            unsigned rows, cols;
+            if (sscanf(argv[++i], "%ux%u", &rows, &cols) != 2 || rows > 255 || cols > 255) {
+                Usage(argv[0]);
+                return 2;
+            }
+            pool.rows = (uint8_t)rows;
+            pool.cols = (uint8_t)cols;
+        } else if (!strcmp(argv[i], "--colors") && i + 1 < argc) {
+            pool.colors = (uint8_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--refill-no-match")) {
+            pool.refill_no_match = 1;
+        } else if (!strcmp(argv[i], "--json")) {
+            json = 1;
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+    pool.policy = Sim_FindPolicy(policy_name);
+    if (!pool.policy || threads < 1 || pool.max_moves > SIM_MAX_MOVES ||
+        (uint64_t)seed_base + games > 0xFFFFFFFFu) {
+        Usage(argv[0]);
+        return 2;
+    }
+    Game_t probe;
+    Game_Setup(&probe, NULL, NULL);
+    if (!Game_SetGeometry(&probe, pool.rows, pool.cols, pool.colors)) {
+        fprintf(stderr, "%ux%u with %u colours is not supported by this build (max %dx%d, %d colours%s)\n",
+                pool.rows, pool.cols, pool.colors, BOARD_ROWS, BOARD_COLS, GAME_NUM_COLORS,
+                GAME_RUNTIME_GEOMETRY ? "" : ", fixed geometry");
+        return 2;
+    }
+
+    pool.count = threads;
+    pool.workers = aligned_alloc(SIM_CACHE_LINE, sizeof(SimWorker_t) * (size_t)threads);
+    for (int t = 0; t < threads; t++) {
+        uint32_t b = seed_base + (uint32_t)((uint64_t)games * t / threads);
+        uint32_t e = seed_base + (uint32_t)((uint64_t)games * (t + 1) / threads);
+        atomic_init(&pool.workers[t].range, RANGE_PACK(b, e));
+        pool.workers[t].stats = aligned_alloc(SIM_CACHE_LINE, sizeof(SimStats_t));
+        memset(pool.workers[t].stats, 0, sizeof(SimStats_t));
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int t = 0; t < threads; t++) pthread_create(&pool.workers[t].thread, NULL, Sim_Worker, &pool.workers[t]);
+    for (int t = 0; t < threads; t++) pthread_join(pool.workers[t].thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    // Злиття після join — на гарячому шляху потоки нічого спільного не пишуть
+    SimStats_t *all = calloc(1, sizeof(SimStats_t));
+    for (int t = 0; t < threads; t++) {
+        const SimStats_t *s = pool.workers[t].stats;
+        all->games += s->games;
+        all->capped += s->capped;
+        all->moves += s->moves;
+        for (int i = 0; i <= SIM_MAX_MOVES; i++) all->length[i] += s->length[i];
+        for (int i = 0; i < SIM_DEPTH_BINS; i++) all->depth[i] += s->depth[i];
+        for (int i = 0; i < SIM_SCORE_BINS; i++) all->score[i] += s->score[i];
+    }
+
+    if (json) {
+        printf("{\n  \"rows\": %u, \"cols\": %u, \"colors\": %u,\n  \"policy\": \"%s\", \"games\": %llu, \"seed_base\": %u, \"threads\": %d, \"max_moves\": %u,\n"
+               "  \"capped\": %llu, \"seconds\": %.3f, \"games_per_sec\": %.0f, \"moves_per_sec\": %.0f,\n",
+               pool.rows, pool.cols, pool.colors, policy_name, (unsigned long long)all->games, seed_base, threads, pool.max_moves,
+               (unsigned long long)all->capped, secs, all->games / secs, all->moves / secs);
+        Report_Json("length", all->length, SIM_MAX_MOVES + 1, 1, 0);
+        Report_Json("cascade_depth", all->depth, SIM_DEPTH_BINS, 1, 0);
+        Report_Json("score", all->score, SIM_SCORE_BINS, SIM_SCORE_BIN, 1);
+        printf("}\n");
+    } else {
+        printf("%ux%u, %u colours, policy %s: %llu games on %d threads in %.2f s (%.0f games/s, %.0f moves/s), %llu capped at %u moves\n",
+               pool.rows, pool.cols, pool.colors, policy_name, (unsigned long long)all->games, threads, secs, all->games / secs, all->moves / secs,
+               (unsigned long long)all->capped, pool.max_moves);
+        Report_Text("length", all->length, SIM_MAX_MOVES + 1, 1);
+        Report_Text("cascade depth", all->depth, SIM_DEPTH_BINS, 1);
+        Report_Text("score", all->score, SIM_SCORE_BINS, SIM_SCORE_BIN);
+    }
+
+    for (int t = 0; t < threads; t++) free(pool.workers[t].stats);
+    free(pool.workers);
+    free(all);
+    return 0;
+}
@@ -0,0 +1,142 @@
+/* Перевірка черги передачі UART (txring.c) на змодельованому UART.
+ *   match3_txring [--bytes N] [--seed S] [--max-frame L]
+ * Виробник кладе пакети випадкової довжини 1..L (як Send_Packet і кадри поля),
+ * "переривання" передає їх так само, як прошивка: суцільний шматок з TxRing_Peek
+ * через HAL_UART_Transmit_IT, що читає буфер по байту за такт лінії, а після
+ * останнього байта — TxRing_Consume і наступний шматок. Перевіряється:
+ *   - на лінію виходять саме записані байти, по порядку, без втрат і повторів;
+ *   - запис відхиляється лише тоді, коли пакет справді не вміщається, і тоді не пише
+ *     нічого; відхилений пакет чекає на місце (зворотний тиск), як UART_Send;
+ *   - шматок з TxRing_Peek не перетинає кінця буфера і не виходить за записане;
+ *   - Used + Free = TXRING_SIZE, зокрема після переповнення 16-бітних індексів.
+ * Код виходу 0 — усе гаразд, 1 — порушення. */
+#include "txring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static TxRing_t ring;
+
+// Модель USART1 з HAL_UART_Transmit_IT: поточний шматок і скільки з нього вже передано
+static const uint8_t *tx_chunk;
+static uint16_t tx_len;
+static uint16_t tx_pos;
+
+static uint64_t wire_bytes, chunks, wrapped_chunks, bad_order, bad_peek, bad_space;
+
+static uint32_t Tc_Random(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+// Байт номер k потоку: звірка на лінії не потребує копії всього, що записано
+static uint8_t Tc_StreamByte(uint64_t k) {
+    uint64_t x = k * 0x9E3779B97F4A7C15ull;
+    return (uint8_t)(x >> 56) ^ (uint8_t)k;
+}
+
+static void Tc_CheckSpace(void) {
+    if ((uint32_t)TxRing_Used(&ring) + TxRing_Free(&ring) != TXRING_SIZE || TxRing_Used(&ring) > TXRING_SIZE)
+        bad_space++;
+}
+
+// UART_Tx_Start прошивки
+static void Tc_TxStart(void) {
+    const uint8_t *chunk;
+    if (tx_len) return;
+    uint16_t n = TxRing_Peek(&ring, &chunk);
+    if (n == 0) return;
+    if (n > TxRing_Used(&ring) || chunk < ring.buf || chunk + n > ring.buf + TXRING_SIZE) bad_peek++;
+    if (chunk + n == ring.buf + TXRING_SIZE && n < TxRing_Used(&ring)) wrapped_chunks++;
+    tx_chunk = chunk;
+    tx_len = n;
+    tx_pos = 0;
+    chunks++;
+}
+
+// Один такт лінії: TXE забирає наступний байт прямо з буфера черги
+static void Tc_TxTick(void) {
+    if (!tx_len) return;
+    if (tx_chunk[tx_pos] != Tc_StreamByte(wire_bytes)) bad_order++;
+    wire_bytes++;
+    if (++tx_pos == tx_len) { // HAL_UART_TxCpltCallback
+        TxRing_Consume(&ring, tx_len);
+        tx_len = 0;
+        Tc_TxStart();
+    }
+    Tc_CheckSpace();
+}
+
+static void Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--bytes N] [--seed S] [--max-frame L]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    uint64_t total = 20000000;
+    uint32_t rng = 1, max_frame = 64;
+    uint64_t written = 0, writes = 0, refused = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--bytes") && i + 1 < argc) {
+            total = strtoull(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            rng = (uint32_t)strtoul(argv[++i], NULL, 0);
+            if (rng == 0) rng = 1;
+        } else if (!strcmp(argv[i], "--max-frame") && i + 1 < argc) {
+            max_frame = (uint32_t)strtoul(argv[++i], NULL, 0);
+            if (max_frame < 1) max_frame = 1;
+            if (max_frame > TXRING_SIZE) max_frame = TXRING_SIZE;
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+
+    TxRing_Init(&ring);
+    uint8_t frame[TXRING_SIZE];
+    uint16_t len = 0;
+    while (written < total || tx_len) {
+        // Між двома діями виробника лінія встигає передати 0..7 байт: то обчислення
+        // довше за передачу, то виробник пише пакети підряд і впирається в повну чергу
+        for (uint32_t t = Tc_Random(&rng) % 8; t; t--) Tc_TxTick();
+        if (written >= total) {
+            Tc_TxTick();
+            continue;
+        }
+
+        if (len == 0) {
+            len = (uint16_t)(1 + Tc_Random(&rng) % max_frame);
+            for (uint16_t k = 0; k < len; k++) frame[k] = Tc_StreamByte(written + k);
+        }
+        uint16_t free_before = TxRing_Free(&ring);
+        uint16_t used_before = TxRing_Used(&ring);
+        writes++;
+        if (TxRing_Write(&ring, frame, len)) {
+            if (TxRing_Used(&ring) != used_before + len) bad_space++;
+            written += len;
+            len = 0;
+            Tc_TxStart(); // UART_Send: запуск передачі, якщо UART вільний
+        } else {
+            if (len <= free_before || TxRing_Used(&ring) != used_before) bad_space++;
+            refused++;
+            Tc_TxTick(); // Чекаємо, поки переривання звільнить місце
+        }
+        Tc_CheckSpace();
+    }
+    if (wire_bytes != written || TxRing_Used(&ring) != 0) bad_order++;
+
+    int failed = bad_order || bad_peek || bad_space;
+    printf("%llu bytes in %llu writes (TXRING_SIZE %d, frames 1..%u): %llu refused while full, "
+           "%llu chunks (%.1f bytes on average, %llu cut at the buffer end): "
+           "order %llu, peek %llu, space %llu\n%s\n",
+           (unsigned long long)written, (unsigned long long)(writes - refused), TXRING_SIZE, max_frame,
+           (unsigned long long)refused, (unsigned long long)chunks,
+           chunks ? (double)wire_bytes / chunks : 0.0, (unsigned long long)wrapped_chunks,
+           (unsigned long long)bad_order, (unsigned long long)bad_peek, (unsigned long long)bad_space,
+           failed ? "FAIL" : "OK");
+    return failed;
+}
@@ -0,0 +1,43 @@
+#ifndef HOST_ENGINE_VARIANT_H_
+#define HOST_ENGINE_VARIANT_H_
+
+/* Кілька збірок game.c в одній програмі: файл варіанта визначає ENGINE_VARIANT
+ * (через CMake, разом з GAME_USE_* і GAME_INCREMENTAL_MATCH) і підключає цей
+ * заголовок перед game.c. Публічні імена рушія отримують префікс варіанта, тож
+ * бекенди, вибрані різними макросами, не конфліктують при лінкуванні. */
+#ifndef ENGINE_VARIANT
+#error "ENGINE_VARIANT must name the variant"
+#endif
+
+#define VARIANT_CAT2(a, b) a##_##b
+#define VARIANT_CAT(a, b)  VARIANT_CAT2(a, b)
+#define VARIANT_SYM(name)  VARIANT_CAT(ENGINE_VARIANT, name)
+
+// Назва бекенда для звітів; GAME_USE_* для кожного варіанта задає CMake
+#if GAME_USE_BITBOARD
+#define VARIANT_BACKEND "bitboard"
+#elif GAME_USE_SWAR
+#define VARIANT_BACKEND "swar"
+#else
+#define VARIANT_BACKEND "array"
+#endif
+
+#define Game_Setup            VARIANT_SYM(Game_Setup)
+#define Game_SetGeometry      VARIANT_SYM(Game_SetGeometry)
+#define Game_Init             VARIANT_SYM(Game_Init)
+#define Game_Shuffle          VARIANT_SYM(Game_Shuffle)
+#define Game_Swap             VARIANT_SYM(Game_Swap)
+#define Game_HasPossibleMoves VARIANT_SYM(Game_HasPossibleMoves)
+#define Game_IsMatchPresent   VARIANT_SYM(Game_IsMatchPresent)
+#define Game_FindMoves        VARIANT_SYM(Game_FindMoves)
+#define Game_MarkAllDirty     VARIANT_SYM(Game_MarkAllDirty)
+#define Game_SetStepFrames    VARIANT_SYM(Game_SetStepFrames)
+#define Game_SetRefillNoMatch VARIANT_SYM(Game_SetRefillNoMatch)
+#define Game_SetScoreTable    VARIANT_SYM(Game_SetScoreTable)
+#define Game_ZobristKey       VARIANT_SYM(Game_ZobristKey)
+#define Game_Fingerprint      VARIANT_SYM(Game_Fingerprint)
+#define Game_SetEventLog      VARIANT_SYM(Game_SetEventLog)
+#define Game_ClearEvents      VARIANT_SYM(Game_ClearEvents)
+#define Game_RunGravityLoop   VARIANT_SYM(Game_RunGravityLoop)
+
+#endif /* HOST_ENGINE_VARIANT_H_ */
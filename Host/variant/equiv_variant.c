@@ -0,0 +1,79 @@
+/* Один варіант рушія для match3_equiv: game.c з бекендом і GAME_INCREMENTAL_MATCH,
+ * заданими через CMake, під іменами з префіксом ENGINE_VARIANT. */
+#include "engine_variant.h"
+#include "../../MCU/Core/Src/game.c"
+#include "variant.h"
+
+static Game_t eq_game;
+static VariantSnap_t *eq_steps;
+static uint16_t eq_max_steps;
+static uint16_t eq_count;
+
+static void Eq_Snap(const Game_t *g, VariantSnap_t *out) {
+    memcpy(out->board, g->board, sizeof(out->board));
+    out->score = g->score;
+    out->fingerprint = Game_Fingerprint(g);
+}
+
+static void Eq_Record(Game_t *g) {
+    if (eq_count < eq_max_steps) Eq_Snap(g, &eq_steps[eq_count]);
+    eq_count++;
+}
+
+static void Eq_Step(Game_t *g, void *ctx) {
+    (void)ctx;
+    Eq_Record(g);
+}
+
+static void Eq_Init(uint32_t seed, uint8_t refill_no_match) {
+    Game_Setup(&eq_game, Eq_Step, NULL);
+    Game_SetRefillNoMatch(&eq_game, refill_no_match);
+    Game_Init(&eq_game, seed);
+}
+
+static uint16_t Eq_Play(const VariantMove_t *m, VariantSnap_t *steps, uint16_t max_steps) {
+    eq_steps = steps;
+    eq_max_steps = max_steps;
+    eq_count = 0;
+    if (!Game_Swap(&eq_game, m->r1, m->c1, m->r2, m->c2)) return 0;
+    Eq_Record(&eq_game); // Кадр обміну (UI_Update_Step у main.c)
+    Game_RunGravityLoop(&eq_game);
+    if (!Game_FindMoves(&eq_game, NULL, 1)) {
+        Game_Shuffle(&eq_game);
+        Eq_Record(&eq_game);
+    }
+    return eq_count < max_steps ? eq_count : max_steps;
+}
+
+static void Eq_SnapNow(VariantSnap_t *out) {
+    Eq_Snap(&eq_game, out);
+}
+
+static uint16_t Eq_FindMoves(VariantMove_t *moves, uint16_t max_moves) {
+    GameMove_t found[GAME_MAX_MOVES];
+    uint16_t n = Game_FindMoves(&eq_game, found, max_moves < GAME_MAX_MOVES ? max_moves : GAME_MAX_MOVES);
+    for (uint16_t i = 0; i < n; i++) {
+        moves[i] = (VariantMove_t){ found[i].r1, found[i].c1, found[i].r2, found[i].c2 };
+    }
+    return n;
+}
+
+// Обмін без згорання на копії: Game_IsMatchPresent бачить поле з готовими лініями
+static int Eq_MatchAfter(const VariantMove_t *m) {
+    Game_t probe = eq_game;
+    uint8_t t = probe.board[m->r1][m->c1];
+    probe.board[m->r1][m->c1] = probe.board[m->r2][m->c2];
+    probe.board[m->r2][m->c2] = t;
+    Game_MarkAllDirty(&probe);
+    return Game_IsMatchPresent(&probe);
+}
+
+const EngineVariant_t VARIANT_SYM(variant) = {
+    VARIANT_BACKEND,
+    GAME_INCREMENTAL_MATCH,
+    Eq_Init,
+    Eq_Play,
+    Eq_SnapNow,
+    Eq_FindMoves,
+    Eq_MatchAfter,
+};
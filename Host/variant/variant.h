@@ -0,0 +1,36 @@
+#ifndef HOST_VARIANT_H_
+#define HOST_VARIANT_H_
+
+#include <stdint.h>
+
+/* Рушій одного варіанта збірки (engine_variant.h) за інтерфейсом, що не залежить
+ * від Game_t: розкладка Game_t різна для різних бекендів. Поле — сталі 8x8. */
+#define VARIANT_ROWS      8
+#define VARIANT_COLS      8
+#define VARIANT_MAX_MOVES (VARIANT_ROWS * (VARIANT_COLS - 1) + (VARIANT_ROWS - 1) * VARIANT_COLS)
+#define VARIANT_MAX_STEPS 1024 // Кроків анімації за один хід; довший каскад обрізається
+
+typedef struct {
+    uint8_t r1, c1;
+    uint8_t r2, c2;
+} VariantMove_t;
+
+typedef struct {
+    uint8_t  board[VARIANT_ROWS][VARIANT_COLS];
+    uint32_t score;
+    uint32_t fingerprint;
+} VariantSnap_t;
+
+typedef struct {
+    const char *backend; // "bitboard", "array", "swar"
+    uint8_t incremental; // GAME_INCREMENTAL_MATCH
+    void (*init)(uint32_t seed, uint8_t refill_no_match);
+    // Хід так, як його робить прошивка на 0x11: обмін, кадр обміну, каскад з покроковими
+    // кадрами, перемішування в тупику. Знімок після кожного кроку; 0 — обмін відхилено.
+    uint16_t (*play)(const VariantMove_t *m, VariantSnap_t *steps, uint16_t max_steps);
+    void (*snap)(VariantSnap_t *out);
+    uint16_t (*find_moves)(VariantMove_t *moves, uint16_t max_moves); // Game_FindMoves
+    int (*match_after)(const VariantMove_t *m); // Game_IsMatchPresent на копії після обміну без згорання
+} EngineVariant_t;
+
+#endif /* HOST_VARIANT_H_ */
@@ -0,0 +1,32 @@
+#ifndef INC_BENCH_H_
+#define INC_BENCH_H_
+
+#include <stdint.h>
+
+/* Мікробенчмарки гарячих шляхів рушія. Ті самі випадки й ті самі поля
+ * міряються на платі (такти SysTick, команда 0x50) і на ПК (Host/bench),
+ * тож числа можна порівнювати рядок у рядок. У звичайній прошивці вимкнено. */
+#ifndef GAME_BENCH
+#define GAME_BENCH 0
+#endif
+
+#if GAME_BENCH
+
+typedef struct {
+    const char *name;
+    void (*setup)(void);          // Готує фікстури; у вимір не входить
+    void (*run)(uint32_t iters);  // iters операцій підряд
+} BenchCase_t;
+
+extern const BenchCase_t bench_cases[];
+extern const uint8_t bench_case_count;
+extern volatile uint32_t bench_sink; // Результати операцій, щоб компілятор їх не викинув
+
+#ifdef USE_HAL_DRIVER
+uint32_t Bench_Cycles(void);                 // Лічильник тактів ядра на основі SysTick (на M0 немає DWT)
+uint32_t Bench_CyclesPerOp(uint8_t id);      // Прогін випадку id, такти на одну операцію
+#endif
+
+#endif /* GAME_BENCH */
+
+#endif /* INC_BENCH_H_ */
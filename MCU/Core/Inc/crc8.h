@@ -0,0 +1,9 @@
+#ifndef INC_CRC8_H_
+#define INC_CRC8_H_
+
+#include <stdint.h>
+
+/* CRC-8, поліном 0x07, початкове значення 0x00 (див. README, "Валідація та CRC-8") */
+uint8_t CRC8_Calc(const uint8_t *data, uint16_t len); // len до 65535: кадр усього поля (0x61) на великому полі довший за 255
+
+#endif /* INC_CRC8_H_ */
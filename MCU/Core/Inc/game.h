@@ -3,15 +3,188 @@
 
 #include <stdint.h>
 
+/* Розміри поля й кількість кольорів (3..32 рядки, 4..32 стовпчики, 3..8 кольорів).
+ * Типово геометрія стала: усі цикли рушія мають межі-константи, як і раніше для 8x8.
+ * GAME_RUNTIME_GEOMETRY 1 — розміри задає Game_SetGeometry, а BOARD_ROWS, BOARD_COLS
+ * і GAME_NUM_COLORS стають верхніми межами (під них виділено пам'ять у Game_t). */
+#ifndef BOARD_ROWS
 #define BOARD_ROWS 8
+#endif
+#ifndef BOARD_COLS
 #define BOARD_COLS 8
+#endif
+#ifndef GAME_NUM_COLORS
+#define GAME_NUM_COLORS 6 // Не менше 3: при заповненні клітинці забороняють до двох кольорів
+#endif
+#ifndef GAME_RUNTIME_GEOMETRY
+#define GAME_RUNTIME_GEOMETRY 0
+#endif
 
-extern uint8_t board[BOARD_ROWS][BOARD_COLS];
-extern uint32_t score;
+/* Очки за одне згорання: 3, 4 і 5+ кульок. Типово — таблиця з README; інші
+ * можна задати Game_SetScoreTable (напр. для підбору балансу на ПК). */
+#define GAME_SCORE_TABLE_SIZE 3
+#define GAME_SCORE_DEFAULT_3  30
+#define GAME_SCORE_DEFAULT_4  60
+#define GAME_SCORE_DEFAULT_5  100
 
-void Game_Init(void);
-uint8_t Game_Swap(uint8_t r1, uint8_t c1, uint8_t r2, uint8_t c2);
-uint8_t Game_HasPossibleMoves(void);
-void Game_RunGravityLoop(void); // <-- Нова функція для обробки гравітації
+/* Версія правил рушія (генератор, падіння, очки): записи гри (replay.h) інших
+ * версій не відтворюються. Збільшувати з кожною зміною, після якої ті самі
+ * зерно й ходи дають інше поле чи рахунок. */
+#define GAME_ENGINE_VERSION 1
+
+#define GAME_MIN_ROWS   3
+#define GAME_MIN_COLS   4 // Game_Shuffle закладає хід "k k . k"
+#define GAME_MIN_COLORS 3
+
+#if BOARD_ROWS < GAME_MIN_ROWS || BOARD_ROWS > 32 || BOARD_COLS < GAME_MIN_COLS || BOARD_COLS > 32
+#error "Board size must be 3..32 rows by 4..32 columns (dirty_rows/dirty_cols are uint32_t)"
+#endif
+#if GAME_NUM_COLORS < GAME_MIN_COLORS || GAME_NUM_COLORS > 8
+#error "GAME_NUM_COLORS must be 3..8"
+#endif
+
+/* Бекенд пошуку збігів: GAME_USE_SWAR 1 — рядки, упаковані по 4 біти на клітинку
+ * в uint32_t (лише 32-бітна арифметика, для Cortex-M0); інакше GAME_USE_BITBOARD
+ * 1 — бітборд (64-бітна маска на кожен колір), 0 — побайтове сканування масиву board.
+ * Поведінка однакова. Бітборд — типовий, якщо поле вміщається в 8 стовпчиків по 8 рядків;
+ * обидва упаковані бекенди потребують сталої геометрії. */
+#ifndef GAME_USE_SWAR
+#define GAME_USE_SWAR 0
+#endif
+
+#ifndef GAME_USE_BITBOARD
+#define GAME_USE_BITBOARD (!GAME_USE_SWAR && !GAME_RUNTIME_GEOMETRY && BOARD_COLS == 8 && BOARD_ROWS <= 8)
+#endif
+
+#if GAME_USE_SWAR && GAME_USE_BITBOARD
+#error "GAME_USE_SWAR and GAME_USE_BITBOARD are mutually exclusive"
+#endif
+#if GAME_USE_SWAR && (BOARD_COLS > 8 || GAME_NUM_COLORS > 7)
+#error "GAME_USE_SWAR packs a row into one uint32_t with 3-bit colours: BOARD_COLS <= 8, GAME_NUM_COLORS <= 7"
+#endif
+#if GAME_USE_BITBOARD && (BOARD_COLS != 8 || BOARD_ROWS > 8)
+#error "GAME_USE_BITBOARD needs BOARD_COLS == 8 and BOARD_ROWS <= 8"
+#endif
+#if GAME_RUNTIME_GEOMETRY && (GAME_USE_SWAR || GAME_USE_BITBOARD)
+#error "GAME_RUNTIME_GEOMETRY works only with the array backend"
+#endif
+
+/* 1 — Game_CheckAndRemoveMatches перевіряє лише рядки й стовпчики, де змінилися
+ * клітинки з часу попередньої перевірки; 0 — завжди все поле. Результат однаковий. */
+#ifndef GAME_INCREMENTAL_MATCH
+#define GAME_INCREMENTAL_MATCH 1
+#endif
+
+/* Максимальна кількість різних обмінів сусідніх клітинок на полі (за верхніми межами) */
+#define GAME_MAX_MOVES ((BOARD_ROWS * (BOARD_COLS - 1)) + ((BOARD_ROWS - 1) * BOARD_COLS))
+
+/* Хід: обмін (r1, c1) з сусідньою (r2, c2); (r1, c1) — ліва або верхня клітинка */
+typedef struct {
+    uint8_t r1, c1;
+    uint8_t r2, c2;
+} GameMove_t;
+
+/* Журнал подій каскаду: що саме змінилося на полі, у порядку змін. Застосовані
+ * послідовно до копії поля, події дають той самий стан, що бачить колбек анімації.
+ * З покроковими кадрами падіння записується по одному рядку за кадр, без них — одразу
+ * на кінцеве місце. Game_Init, Game_Shuffle і Load_Game журнал не пишуть. */
+typedef enum {
+    GAME_EV_SWAP = 1, // Обмін (a, b) з сусідом: c = 0 — праворуч, 1 — знизу
+    GAME_EV_CLEAR,    // Кулька (a, b) згоріла; c — номер її групи (молодший байт)
+    GAME_EV_FALL,     // Кулька стовпчика c переходить з рядка a в рядок b (a стає порожньою)
+    GAME_EV_SPAWN,    // Нова кулька кольору c у (a, b)
+    GAME_EV_SCORE,    // Рахунок зріс на (a << 16) | (b << 8) | c
+    GAME_EV_GROUP,    // Група c: a кульок (не більше 255), b = (GameShape_t << 4) | колір
+} GameEventType_t;
+
+/* Група — зв'язна по сторонах область згорілих кульок одного кольору. Кожна група
+ * пишеться в журнал як GROUP, SCORE (очки саме за неї), далі CLEAR кожної її кульки.
+ * Номер групи в подіях — молодший байт лічильника кроку: понад 255 груп за крок буває
+ * лише на великих полях GAME_RUNTIME_GEOMETRY, і тоді групу визначає її GROUP перед CLEAR. */
+typedef enum {
+    GAME_SHAPE_LINE = 0, // Одна лінія
+    GAME_SHAPE_L,        // Дві лінії, що сходяться кінцями
+    GAME_SHAPE_T,        // Кінець однієї лінії посередині другої
+    GAME_SHAPE_CROSS,    // Лінії перетинаються посередині обох
+    GAME_SHAPE_OTHER,    // Кілька паралельних ліній поруч тощо
+} GameShape_t;
+
+/* Найбільше подій за один крок анімації: обмін, згорання всього поля,
+ * по GROUP і SCORE на кожну групу (група — щонайменше 3 кульки) */
+#define GAME_MAX_STEP_EVENTS (1 + BOARD_ROWS * BOARD_COLS + 2 * (BOARD_ROWS * BOARD_COLS / 3))
+
+typedef struct {
+    uint8_t type; // GameEventType_t
+    uint8_t a, b, c;
+} GameEvent_t;
+
+typedef struct Game_s Game_t;
+
+/* Викликається після кожного кроку анімації, коли поле вже в новому стані */
+typedef void (*GameUiCallback_t)(Game_t *g, void *ctx);
+
+/* Стан однієї гри. Глобальних змінних у рушії немає: прошивка тримає
+ * один статичний екземпляр, хост може мати тисячі в суцільному масиві. */
+struct Game_s {
+    uint8_t  board[BOARD_ROWS][BOARD_COLS];
+    uint32_t score;
+    uint32_t seed;               // Зерно, з якого згенеровано це поле (для відтворення)
+    uint32_t rng_state;          // Поточний стан xorshift32, ніколи не 0
+    uint64_t hash;               // Zobrist-відбиток поля (XOR Game_ZobristKey усіх клітинок); під час кадрів падіння — кінцевого
+
+    GameUiCallback_t ui_update;  // Може бути NULL
+    void    *ui_ctx;
+    uint8_t  step_frames;        // 0 — гравітація без проміжних кадрів (клієнт анімує сам)
+    uint8_t  refill_no_match;    // 1 — нові кульки згори не утворюють ліній (з 3 кольорами — не завжди)
+    uint16_t score_table[GAME_SCORE_TABLE_SIZE]; // Очки за згорання 3, 4 і 5+ кульок
+#if GAME_RUNTIME_GEOMETRY
+    uint8_t  rows, cols, num_colors; // Активна геометрія, не більша за BOARD_ROWS, BOARD_COLS, GAME_NUM_COLORS
+#endif
+
+    GameEvent_t *events;         // Журнал подій (NULL — вимкнено); копія Game_t пише в той самий буфер
+    uint16_t event_cap;
+    uint16_t event_count;
+    uint8_t  event_overflow;     // 1 — подія не вмістилася; стан поля треба передати цілком
+    uint16_t event_group;        // Номер наступної групи згорання в кроці (у подіях — молодший байт)
+
+    // Рядки й стовпчики, де змінилися клітинки після останньої перевірки на лінії
+    uint32_t dirty_rows;
+    uint32_t dirty_cols;
+#if GAME_USE_BITBOARD
+    uint64_t color_masks[GAME_NUM_COLORS + 1]; // Синхронні з board (індекс 0 — порожні клітинки)
+#elif GAME_USE_SWAR
+    uint32_t rows[BOARD_ROWS];                 // Синхронні з board: клітинка c — біти 4c..4c+3
+#endif
+};
+
+/* Активна геометрія: у сталому режимі — константи, тож цикли розгортаються як раніше */
+#if GAME_RUNTIME_GEOMETRY
+#define GAME_ROWS(g)   ((g)->rows)
+#define GAME_COLS(g)   ((g)->cols)
+#define GAME_COLORS(g) ((g)->num_colors)
+#else
+#define GAME_ROWS(g)   BOARD_ROWS
+#define GAME_COLS(g)   BOARD_COLS
+#define GAME_COLORS(g) GAME_NUM_COLORS
+#endif
+
+void Game_Setup(Game_t *g, GameUiCallback_t ui_update, void *ui_ctx);
+int  Game_SetGeometry(Game_t *g, uint8_t rows, uint8_t cols, uint8_t colors); // 0 — не підтримується; далі Game_Init
+void Game_Init(Game_t *g, uint32_t seed); // Однакові seed і послідовність ходів дають однакове поле; хід є завжди
+void Game_Shuffle(Game_t *g); // Нове поле без ліній і з ходом замість тупикового, за сталий час
+
+uint8_t Game_Swap(Game_t *g, uint8_t r1, uint8_t c1, uint8_t r2, uint8_t c2);
+uint8_t Game_HasPossibleMoves(const Game_t *g);
+int Game_IsMatchPresent(const Game_t *g); // Чи є на полі готова лінія з трьох
+uint16_t Game_FindMoves(const Game_t *g, GameMove_t *moves, uint16_t max_moves);
+void Game_MarkAllDirty(Game_t *g); // Викликати після зміни g->board поза game.c (напр. Load_Game)
+void Game_SetStepFrames(Game_t *g, uint8_t enabled); // 0 — гравітація без проміжних кадрів (клієнт анімує сам)
+void Game_SetRefillNoMatch(Game_t *g, uint8_t enabled); // 1 — поповнення не запускає каскадів само по собі
+void Game_SetScoreTable(Game_t *g, const uint16_t table[GAME_SCORE_TABLE_SIZE]); // NULL — типова таблиця
+uint64_t Game_ZobristKey(uint8_t r, uint8_t c, uint8_t color); // Ключ клітинки; для порожньої — 0
+uint32_t Game_Fingerprint(const Game_t *g); // 32-бітна згортка hash для звірки поля клієнта з платою (0x1C)
+void Game_SetEventLog(Game_t *g, GameEvent_t *buf, uint16_t capacity); // buf = NULL — без журналу
+void Game_ClearEvents(Game_t *g); // Після того, як споживач прочитав журнал
+void Game_RunGravityLoop(Game_t *g); // <-- Нова функція для обробки гравітації
 
 #endif /* INC_GAME_H_ */
@@ -0,0 +1,45 @@
+#ifndef INC_HISTORY_H_
+#define INC_HISTORY_H_
+
+#include <stdint.h>
+#include "game.h"
+
+/* Історія ходів для UNDO/REDO (0x1A/0x1B) у кільцевому буфері в RAM.
+ * Запис — не знімок поля, а різниця "до/після" ходу, закодована через XOR:
+ * клітинки, що змінилися (позиція й old ^ new), рахунок і стан генератора.
+ * XOR сам собі обернений, тож скасування й повтор — та сама операція над
+ * записом. Коли місце закінчується, найстаріші ходи витісняються. */
+#ifndef HISTORY_BYTES
+#define HISTORY_BYTES 1536 // ~30-50 звичайних ходів поля 8x8
+#endif
+
+#if HISTORY_BYTES > 65535
+#error "HISTORY_BYTES must fit uint16_t ring offsets"
+#endif
+
+typedef struct {
+    uint8_t  buf[HISTORY_BYTES];
+    uint16_t tail;       // Початок найстарішого запису
+    uint16_t cursor;     // Кінець останнього ходу, який можна скасувати
+    uint16_t undo_bytes; // Байтів від tail до cursor
+    uint16_t redo_bytes; // Байтів скасованих ходів після cursor
+    uint16_t undo_count;
+    uint16_t redo_count;
+
+    // Стан між History_Begin і History_Commit: поле до ходу
+    uint8_t  before[BOARD_ROWS][BOARD_COLS];
+    uint32_t score_before;
+    uint32_t rng_before;
+    uint8_t  pending;    // 1 — History_Begin без History_Commit
+} History_t;
+
+void History_Clear(History_t *h); // Нова гра, завантаження: старі ходи до поточного поля не підходять
+void History_Begin(History_t *h, const Game_t *g);  // Перед ходом (0x11) або перемішуванням (0x18)
+void History_Commit(History_t *h, const Game_t *g); // Після каскаду; хід без змін не записується
+
+/* Повертають 1, якщо поле змінено. touched (може бути NULL): біт c елемента r —
+ * клітинка (r, c) змінилася, решта бітів не чіпається. */
+uint8_t History_Undo(History_t *h, Game_t *g, uint32_t touched[BOARD_ROWS]);
+uint8_t History_Redo(History_t *h, Game_t *g, uint32_t touched[BOARD_ROWS]);
+
+#endif /* INC_HISTORY_H_ */
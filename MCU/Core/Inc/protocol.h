@@ -9,11 +9,24 @@
 #define CMD_FINISH          0x12
 #define CMD_GET_SCORE       0x15
 #define CMD_UPDATE_CELL     0x16
+#define CMD_HINT            0x17
+#define CMD_SHUFFLE         0x18
+#define CMD_GET_GEOMETRY    0x19
+#define CMD_UNDO            0x1A
+#define CMD_REDO            0x1B
+#define CMD_GET_FINGERPRINT 0x1C
+#define CMD_GET_BOARD       0x1D
+#define CMD_MATCH_GROUP     0x1E
+#define CMD_GET_REPLAY      0x1F
 #define CMD_SET_NAME        0x20
 #define CMD_SAVE            0x30
 #define CMD_LOAD            0x31
 #define CMD_GET_SLOT_NAME   0x32
 #define CMD_GET_LEADERBOARD 0x40
+#define CMD_BENCH           0x50   /* Лише у збірці з GAME_BENCH=1 */
+#define CMD_HELLO           0x60   /* Можливості клієнта/плати (CAP_*) в ADDR_H */
+#define CMD_BOARD_PACKED    0x61   /* Кадр змінної довжини, див. README */
+#define CMD_BOARD_DELTA     0x62   /* Кадр змінної довжини, див. README */
 
 /* =========================================================
  * Статуси відповіді (STATUS)
@@ -23,4 +36,12 @@
 #define STATUS_ERROR        0xEE   /* Помилка / слот порожній */
 #define STATUS_UNKNOWN      0xFF   /* Невідома команда       */
 
+/* =========================================================
+ * Можливості (ADDR_H у CMD_HELLO)
+ * ========================================================= */
+#define CAP_PACKED_BOARD    0x01   /* Усе поле одним кадром 0x61 замість пакетів 0x16 */
+#define CAP_DELTA_FRAME     0x02   /* Зміни кроку анімації одним кадром 0x62 */
+#define CAP_CASCADE_BURST   0x04   /* Каскад без пауз між кроками, темп задає клієнт */
+#define CAP_LOCAL_FALL      0x08   /* Падіння — одним кадром кінцевого стану, анімує клієнт */
+
 #endif /* INC_PROTOCOL_H_ */
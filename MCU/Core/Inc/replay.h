@@ -0,0 +1,64 @@
+#ifndef INC_REPLAY_H_
+#define INC_REPLAY_H_
+
+#include <stdint.h>
+#include "game.h"
+
+/* Запис гри для перевірки рекордів: зерно + послідовність дій відтворюють гру
+ * на ПК (match3_replay). Файл (числа — little-endian):
+ *   "M3RP" | формат (1) | версія рушія (1) | рядки | стовпчики | кольори | прапорці (1)
+ *   | seed (4) | рахунок (4) | Game_Fingerprint (4) | кількість дій (4) | дії
+ * Рахунок і відбиток — заявлений кінцевий стан, його й звіряє перевірка.
+ * Дія — varint (LEB128) коду: 0 — перемішування (0x18), 1 — UNDO, 2 — REDO,
+ * 3 + i — обмін з номером i (спершу горизонтальні (r,c)-(r,c+1) по рядках,
+ * далі вертикальні (r,c)-(r+1,c)). На полі 8x8 будь-яка дія — 1 байт.
+ * Відхилені обміни не пишуться; перемішування після тупика неявне, як у прошивці. */
+#define REPLAY_FORMAT_VERSION 1
+#define REPLAY_HEADER_BYTES   26
+
+#define REPLAY_OP_SHUFFLE 0
+#define REPLAY_OP_UNDO    1
+#define REPLAY_OP_REDO    2
+#define REPLAY_OP_SWAP    3 // Перший код обміну
+
+#define REPLAY_FLAG_TRUNCATED 0x01 // Буфер закінчився: записано лише початок гри
+#define REPLAY_FLAG_LOADED    0x02 // Гру завантажено зі слота: із зерна її не відтворити
+
+#ifndef REPLAY_BYTES
+#define REPLAY_BYTES 1024 // ~1000 дій поля 8x8
+#endif
+
+#if REPLAY_BYTES > 65535
+#error "REPLAY_BYTES must fit uint16_t"
+#endif
+
+typedef struct {
+    uint8_t  buf[REPLAY_BYTES]; // Дії без заголовка: його складає Replay_WriteHeader
+    uint16_t len;
+    uint8_t  flags;
+    uint32_t count;
+} Replay_t;
+
+typedef struct {
+    uint8_t  format, engine;
+    uint8_t  rows, cols, colors;
+    uint8_t  flags;
+    uint32_t seed;
+    uint32_t score;
+    uint32_t fingerprint;
+    uint32_t count;
+} ReplayHeader_t;
+
+void Replay_Clear(Replay_t *r, uint8_t flags); // Нова гра (0), завантаження (REPLAY_FLAG_LOADED)
+void Replay_RecordOp(Replay_t *r, uint32_t code); // REPLAY_OP_SHUFFLE/UNDO/REDO
+void Replay_RecordSwap(Replay_t *r, const Game_t *g, uint8_t r1, uint8_t c1, uint8_t r2, uint8_t c2); // Лише вдалий обмін
+void Replay_WriteHeader(const Replay_t *r, const Game_t *g, uint8_t out[REPLAY_HEADER_BYTES]);
+
+/* Читання (ПК): 0 — не файл запису або обрізаний заголовок */
+int Replay_ReadHeader(const uint8_t *data, uint32_t len, ReplayHeader_t *h);
+/* Наступний код дії з *pos; 0 — дані скінчилися або varint обрізаний */
+int Replay_NextCode(const uint8_t *data, uint32_t len, uint32_t *pos, uint32_t *code);
+/* Код обміну -> клітинки; 0 — такого обміну на полі rows x cols немає */
+int Replay_DecodeSwap(uint8_t rows, uint8_t cols, uint32_t code, GameMove_t *m);
+
+#endif /* INC_REPLAY_H_ */
@@ -7,7 +7,9 @@
 /* Константи адрес Flash-пам'яті */
 #define FLASH_LEADERBOARD_ADDR 0x0800F800 // Сторінка для таблиці лідерів
 #define FLASH_SAVE_ADDR        0x0800FC00 // Сторінка для ігрових слотів
+#define FLASH_PAGE_BYTES       1024       // Усі слоти мають вміститися в одну сторінку
 #define SAVE_MAGIC_NUMBER      0xABBA1234
+#define SAVE_SLOT_MAGIC        0xABBA1236 // Слоти з геометрією поля; старі збереження вважаються порожніми
 #define MAX_SAVE_SLOTS         3
 #define MAX_LEADERS            5
 
@@ -17,6 +19,10 @@ typedef struct {
     uint32_t score;
     char     playerName[16];
     uint8_t  board[BOARD_ROWS][BOARD_COLS];
+    uint32_t seed;      // Зерно початкового поля
+    uint32_t rng_state; // Стан генератора на момент збереження — гра продовжиться так само
+    uint8_t  rows, cols, num_colors; // Геометрія гри; слот іншої геометрії не завантажується
+    uint8_t  reserved;
 } GameSaveData_t;
 
 /* Структури для таблиці лідерів */
@@ -34,8 +40,8 @@ typedef struct {
 extern char current_player_name[16];
 
 /* Функції збереження/завантаження гри */
-void Save_Game(uint8_t slot);
-int  Load_Game(uint8_t slot);
+void Save_Game(const Game_t *g, uint8_t slot);
+int  Load_Game(Game_t *g, uint8_t slot);
 
 /* Функції роботи з таблицею лідерів */
 void Update_Leaderboard(uint32_t final_score, const char* name);
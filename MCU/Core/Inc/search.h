@@ -0,0 +1,58 @@
+#ifndef INC_SEARCH_H_
+#define INC_SEARCH_H_
+
+#include <stdint.h>
+#include "game.h"
+
+/* Пошук найкращого ходу: обмеженої глибини expectimax над випадковими поповненнями.
+ * Вузол гравця — найкращий з усіх ходів, вузол випадку — середнє за cfg->samples
+ * прогонами ходу з різними станами генератора (замість перебору всіх кольорів, що
+ * впадуть згори). Стани виводяться з hash поля, тож усі ходи з одного поля
+ * порівнюються на тих самих вибірках, а результат відтворюваний.
+ * Цінність — очікувані очки (згорання + каскад) × SEARCH_SCALE за depth ходів гравця.
+ * Плата кличе глибину 1 (підказка 0x17), ПК — глибше, у кількох потоках (Host/search). */
+#define SEARCH_SCALE 16
+
+/* Необов'язковий кеш цінностей вузлів гравця (таблиця транспозицій на ПК).
+ * key уже враховує глибину; probe повертає 1, якщо *value знайдено. */
+typedef int  (*SearchCacheProbe_t)(void *ctx, uint64_t key, int32_t *value);
+typedef void (*SearchCacheStore_t)(void *ctx, uint64_t key, int32_t value, uint8_t depth);
+
+typedef struct {
+    uint8_t  max_depth;          // Ходів гравця вперед, 1 — лише оцінюваний хід
+    uint8_t  samples;            // Вибірок на вузол випадку, не менше 1
+    uint32_t budget_us;          // Ітеративне поглиблення зупиняється, коли час вичерпано; 0 — без обмеження
+    uint32_t (*now_us)(void);    // Годинник для budget_us; NULL — без обмеження
+    SearchCacheProbe_t cache_probe; // NULL — без кешу
+    SearchCacheStore_t cache_store;
+    void    *cache_ctx;
+} SearchConfig_t;
+
+typedef struct {
+    GameMove_t move;
+    int32_t    value;            // Очікувані очки × SEARCH_SCALE
+} SearchMove_t;
+
+typedef struct {
+    uint8_t  depth;              // Найбільша повністю пройдена глибина
+    uint32_t nodes;              // Змодельованих ходів
+} SearchStats_t;
+
+/* Стан одного прогону; потоки ПК мають кожен свій */
+typedef struct {
+    const SearchConfig_t *cfg;
+    uint32_t start_us;
+    uint32_t nodes;
+    uint8_t  check_time;         // 0 — глибина 1: її завжди доводимо до кінця
+    uint8_t  aborted;            // 1 — час вичерпано, значення прогону недійсні
+} SearchRun_t;
+
+// До k найкращих ходів за спаданням цінності; повертає їх кількість (0 — ходів немає)
+uint16_t Search_BestMoves(const Game_t *g, const SearchConfig_t *cfg, SearchMove_t *out, uint16_t k, SearchStats_t *stats);
+
+// Будівельні блоки для паралельного пошуку на ПК
+void    Search_RunInit(SearchRun_t *run, const SearchConfig_t *cfg, uint32_t start_us, uint8_t depth);
+int32_t Search_EvaluateMove(const Game_t *g, const GameMove_t *m, uint8_t depth, SearchRun_t *run);
+void    Search_SortMoves(SearchMove_t *moves, uint16_t n); // За спаданням цінності, рівні зберігають порядок
+
+#endif /* INC_SEARCH_H_ */
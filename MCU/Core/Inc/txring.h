@@ -0,0 +1,31 @@
+#ifndef INC_TXRING_H_
+#define INC_TXRING_H_
+
+#include <stdint.h>
+
+/* Черга байтів на передачу UART: основний цикл кладе пакети й кадри (TxRing_Write),
+ * переривання передає їх суцільними шматками (TxRing_Peek, після передачі TxRing_Consume).
+ * Один виробник і один споживач: head змінює лише виробник, tail — лише споживач, тож
+ * блокування не потрібне. Індекси ростуть без обмеження й беруться за модулем розміру. */
+#ifndef TXRING_SIZE
+#define TXRING_SIZE 256 // Степінь двійки; найдовший кадр мусить уміщатися цілим
+#endif
+
+#if TXRING_SIZE < 2 || TXRING_SIZE > 32768 || (TXRING_SIZE & (TXRING_SIZE - 1))
+#error "TXRING_SIZE must be a power of two, 2..32768 (uint16_t free-running indices)"
+#endif
+
+typedef struct {
+    uint8_t buf[TXRING_SIZE];
+    volatile uint16_t head; // Скільки байт записано за весь час (по модулю 2^16)
+    volatile uint16_t tail; // Скільки байт передано
+} TxRing_t;
+
+void TxRing_Init(TxRing_t *r);
+uint16_t TxRing_Used(const TxRing_t *r); // Байти, що чекають на передачу (разом з тими, що передаються)
+uint16_t TxRing_Free(const TxRing_t *r);
+int TxRing_Write(TxRing_t *r, const uint8_t *data, uint16_t len); // 1 — записано все, 0 — не вмістилося й не записано нічого
+uint16_t TxRing_Peek(const TxRing_t *r, const uint8_t **data); // Суцільний шматок від tail до head або до кінця buf; 0 — порожньо
+void TxRing_Consume(TxRing_t *r, uint16_t len); // Після передачі len байт, отриманих з TxRing_Peek
+
+#endif /* INC_TXRING_H_ */
@@ -0,0 +1,258 @@
+#include "bench.h"
+
+#if GAME_BENCH
+
+#include "game.h"
+#include "crc8.h"
+#include <string.h>
+#ifdef USE_HAL_DRIVER
+#include "stm32f0xx_hal.h"
+#endif
+
+#define BENCH_FIXTURES   4   // Полів на випадок; операції ходять по них по колу
+#define BENCH_SCAN_SEEDS 256 // Скільки зерен переглянути, шукаючи найдовші каскади
+
+volatile uint32_t bench_sink;
+
+// Фікстури спільні для всіх випадків: на платі лише 8 КБ RAM
+static Game_t bench_fix[BENCH_FIXTURES];
+static GameMove_t bench_move[BENCH_FIXTURES];
+static Game_t bench_game;
+static uint32_t bench_steps;
+
+static void Bench_CountStep(Game_t *g, void *ctx) {
+    (void)g;
+    (void)ctx;
+    bench_steps++;
+}
+
+static void Bench_NewGame(Game_t *g, uint32_t seed) {
+    Game_Setup(g, NULL, NULL);
+    Game_Init(g, seed);
+}
+
+// Чи є на полі готова лінія з трьох (для перевірки штучних полів)
+static int Bench_HasLine(const Game_t *g) {
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        for (int c = 0; c < BOARD_COLS; c++) {
+            uint8_t k = g->board[r][c];
+            if (c + 2 < BOARD_COLS && g->board[r][c + 1] == k && g->board[r][c + 2] == k) return 1;
+            if (r + 2 < BOARD_ROWS && g->board[r + 1][c] == k && g->board[r + 2][c] == k) return 1;
+        }
+    }
+    return 0;
+}
+
+// Поле без жодного ходу: діагональні смуги з кроком 2, зсунуті на k кольорів
+static void Bench_DeadlockBoard(Game_t *g, int k) {
+    Game_Setup(g, NULL, NULL);
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        for (int c = 0; c < BOARD_COLS; c++) {
+            g->board[r][c] = (uint8_t)(((r * 2 + c + k) % GAME_NUM_COLORS) + 1);
+        }
+    }
+    Game_MarkAllDirty(g);
+}
+
+/* --- Game_Init --- */
+
+static void Bench_InitSetup(void) {
+    Game_Setup(&bench_game, NULL, NULL);
+}
+
+static void Bench_InitRun(uint32_t iters) {
+    for (uint32_t i = 0; i < iters; i++) {
+        Game_Init(&bench_game, i + 1);
+        bench_sink += bench_game.board[0][0];
+    }
+}
+
+/* --- Game_Swap: вдалий обмін (лінія знайдена й прибрана) ---
+ * Після вдалого обміну поле змінене, тож кожна операція спершу копіює
+ * фікстуру; копія контексту входить у виміряний час. */
+
+static void Bench_SwapHitSetup(void) {
+    for (int k = 0; k < BENCH_FIXTURES; k++) {
+        Bench_NewGame(&bench_fix[k], 1000 + k);
+        Game_FindMoves(&bench_fix[k], &bench_move[k], 1);
+    }
+}
+
+static void Bench_SwapHitRun(uint32_t iters) {
+    for (uint32_t i = 0; i < iters; i++) {
+        int k = i % BENCH_FIXTURES;
+        bench_game = bench_fix[k];
+        bench_sink += Game_Swap(&bench_game, bench_move[k].r1, bench_move[k].c1, bench_move[k].r2, bench_move[k].c2);
+    }
+}
+
+/* --- Game_Swap: обмін без лінії (поле повертається як було) --- */
+
+static void Bench_SwapMissSetup(void) {
+    for (int k = 0; k < BENCH_FIXTURES; k++) {
+        Bench_NewGame(&bench_fix[k], 2000 + k);
+        GameMove_t moves[GAME_MAX_MOVES];
+        uint16_t n = Game_FindMoves(&bench_fix[k], moves, GAME_MAX_MOVES);
+        // Перший горизонтальний обмін різних кольорів, якого немає серед ходів
+        for (int p = 0; p < BOARD_ROWS * (BOARD_COLS - 1); p++) {
+            uint8_t r = (uint8_t)(p / (BOARD_COLS - 1)), c = (uint8_t)(p % (BOARD_COLS - 1));
+            int legal = 0;
+            for (int m = 0; m < n; m++) {
+                if (moves[m].r1 == r && moves[m].c1 == c && moves[m].r2 == r && moves[m].c2 == c + 1) legal = 1;
+            }
+            if (!legal && bench_fix[k].board[r][c] != bench_fix[k].board[r][c + 1]) {
+                bench_move[k] = (GameMove_t){ r, c, r, (uint8_t)(c + 1) };
+                break;
+            }
+        }
+    }
+}
+
+static void Bench_SwapMissRun(uint32_t iters) {
+    for (uint32_t i = 0; i < iters; i++) {
+        int k = i % BENCH_FIXTURES;
+        bench_sink += Game_Swap(&bench_fix[k], bench_move[k].r1, bench_move[k].c1, bench_move[k].r2, bench_move[k].c2);
+    }
+}
+
+/* --- Game_HasPossibleMoves --- */
+
+static void Bench_MovesDenseSetup(void) {
+    for (int k = 0; k < BENCH_FIXTURES; k++) {
+        Bench_NewGame(&bench_fix[k], 3000 + k);
+    }
+}
+
+// Майже тупик: у полі без ходів одна клітинка змінена так, що з'являється рівно один хід
+// якомога далі від початку обходу
+static void Bench_MovesNearDeadlockSetup(void) {
+    for (int k = 0; k < BENCH_FIXTURES; k++) {
+        Game_t *g = &bench_fix[k];
+        Bench_DeadlockBoard(g, k);
+        int done = 0;
+        for (int i = BOARD_ROWS * BOARD_COLS - 1; i >= 0 && !done; i--) {
+            int r = i / BOARD_COLS, c = i % BOARD_COLS;
+            uint8_t old = g->board[r][c];
+            for (uint8_t color = 1; color <= GAME_NUM_COLORS && !done; color++) {
+                GameMove_t moves[GAME_MAX_MOVES];
+                g->board[r][c] = color;
+                Game_MarkAllDirty(g);
+                if (!Bench_HasLine(g) && Game_FindMoves(g, moves, GAME_MAX_MOVES) == 1) done = 1;
+            }
+            if (!done) {
+                g->board[r][c] = old;
+                Game_MarkAllDirty(g);
+            }
+        }
+    }
+}
+
+static void Bench_MovesDeadlockSetup(void) {
+    for (int k = 0; k < BENCH_FIXTURES; k++) {
+        Bench_DeadlockBoard(&bench_fix[k], k);
+    }
+}
+
+static void Bench_HasMovesRun(uint32_t iters) {
+    for (uint32_t i = 0; i < iters; i++) {
+        bench_sink += Game_HasPossibleMoves(&bench_fix[i % BENCH_FIXTURES]);
+    }
+}
+
+/* --- Game_RunGravityLoop: найдовші каскади серед BENCH_SCAN_SEEDS ігор ---
+ * Фікстура — стан одразу після вдалого обміну, до гравітації.
+ * Покрокові кадри увімкнені, як у прошивці; колбек порожній. */
+
+static void Bench_GravitySetup(void) {
+    uint32_t best[BENCH_FIXTURES] = { 0 };
+    for (uint32_t seed = 1; seed <= BENCH_SCAN_SEEDS; seed++) {
+        GameMove_t m;
+        Bench_NewGame(&bench_game, seed);
+        if (!Game_FindMoves(&bench_game, &m, 1)) continue;
+        Game_Swap(&bench_game, m.r1, m.c1, m.r2, m.c2);
+
+        Game_t probe = bench_game;
+        probe.ui_update = Bench_CountStep;
+        bench_steps = 0;
+        Game_RunGravityLoop(&probe);
+
+        // Вставка у впорядкований за спаданням список найкращих
+        for (int k = 0; k < BENCH_FIXTURES; k++) {
+            if (bench_steps > best[k]) {
+                for (int j = BENCH_FIXTURES - 1; j > k; j--) {
+                    best[j] = best[j - 1];
+                    bench_fix[j] = bench_fix[j - 1];
+                }
+                best[k] = bench_steps;
+                bench_fix[k] = bench_game;
+                break;
+            }
+        }
+    }
+}
+
+static void Bench_GravityRun(uint32_t iters) {
+    for (uint32_t i = 0; i < iters; i++) {
+        bench_game = bench_fix[i % BENCH_FIXTURES];
+        Game_RunGravityLoop(&bench_game);
+        bench_sink += bench_game.score;
+    }
+}
+
+/* --- CRC8_Calc на пакеті протоколу (5 байт) --- */
+
+static void Bench_CrcSetup(void) {
+}
+
+static void Bench_CrcRun(uint32_t iters) {
+    uint8_t pkt[5] = { 0x11, 3, 4, 3, 5 };
+    for (uint32_t i = 0; i < iters; i++) {
+        pkt[4] = (uint8_t)i;
+        bench_sink += CRC8_Calc(pkt, 5);
+    }
+}
+
+// Порядок — це номери випадків для команди 0x50; не змінювати без Host/bench/mcu_bench.py
+const BenchCase_t bench_cases[] = {
+    { "game_init",                 Bench_InitSetup,              Bench_InitRun },
+    { "swap_hit",                  Bench_SwapHitSetup,           Bench_SwapHitRun },
+    { "swap_miss",                 Bench_SwapMissSetup,          Bench_SwapMissRun },
+    { "has_moves_dense",           Bench_MovesDenseSetup,        Bench_HasMovesRun },
+    { "has_moves_near_deadlock",   Bench_MovesNearDeadlockSetup, Bench_HasMovesRun },
+    { "has_moves_deadlock",        Bench_MovesDeadlockSetup,     Bench_HasMovesRun },
+    { "gravity_cascade",           Bench_GravitySetup,           Bench_GravityRun },
+    { "crc8_packet",               Bench_CrcSetup,               Bench_CrcRun },
+};
+const uint8_t bench_case_count = sizeof(bench_cases) / sizeof(bench_cases[0]);
+
+#ifdef USE_HAL_DRIVER
+/* --- ЛІЧИЛЬНИК ТАКТІВ ---
+ * SysTick рахує вниз від LOAD до 0 щомілісекунди, HAL_GetTick() — кількість
+ * переповнень. Разом це такти ядра; переповнення uint32_t (~89 с на 48 МГц)
+ * не заважає, доки віднімаються близькі значення. */
+uint32_t Bench_Cycles(void) {
+    uint32_t ms, val;
+    do {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick()); // Переривання SysTick між двома читаннями — повторити
+    return ms * (SysTick->LOAD + 1) + (SysTick->LOAD - val);
+}
+
+// Подвоює кількість ітерацій, доки прогін не триватиме хоча б ~50 мс
+uint32_t Bench_CyclesPerOp(uint8_t id) {
+    const uint32_t min_cycles = HAL_RCC_GetHCLKFreq() / 20;
+    uint32_t iters = 1, cycles;
+    bench_cases[id].setup();
+    for (;;) {
+        uint32_t t0 = Bench_Cycles();
+        bench_cases[id].run(iters);
+        cycles = Bench_Cycles() - t0;
+        if (cycles >= min_cycles || iters >= (1u << 20)) break;
+        iters *= 2;
+    }
+    return cycles / iters;
+}
+#endif
+
+#endif /* GAME_BENCH */
@@ -0,0 +1,19 @@
+#include "crc8.h"
+
+uint8_t CRC8_Calc(const uint8_t *data, uint16_t len)
+{
+    uint8_t crc = 0x00;
+    uint16_t i;
+    uint8_t j;
+    for (i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (j = 0; j < 8; j++) {
+            if (crc & 0x80) {
+                crc = (crc << 1) ^ 0x07;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
@@ -2,217 +2,982 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Глобальні змінні
-uint8_t board[BOARD_ROWS][BOARD_COLS];
-uint32_t score = 0;
-
-// Функція оновлення екрану з main.c
-extern void UI_Update_Step(void);
+// Запис одного проходу гравітації — з нього будуються покрокові кадри анімації
+typedef struct {
+    uint8_t fall_dist[BOARD_ROWS][BOARD_COLS]; // На скільки рядків упала кулька, що тепер у (r, c)
+    uint8_t spawn_count[BOARD_COLS];           // Скільки нових кульок з'явилося згори (рядки 0..n-1)
+    uint8_t max_fall;
+    uint8_t max_spawn;
+} GameFall_t;
 
 /* --- ПРОТОТИПИ --- */
-static uint8_t GetValidRandomColor(int r, int c);
-static int Game_GravityStep(void); // Оновлений крок гравітації
-static int Game_CheckAndRemoveMatches(void);
-static uint32_t GetScoreForCount(uint8_t count);
-static int Game_IsMatchPresent(void);
+static uint32_t Game_ForbiddenColors(const Game_t *g, int r, int c);
+static uint8_t Game_PickColor(Game_t *g, uint32_t forbidden);
+static void Game_FillRow(Game_t *g, int r);
+static void Game_CollapseAndRefill(Game_t *g, GameFall_t *fall);
+static void Game_ShowFallFrames(Game_t *g, const GameFall_t *fall);
+static int Game_CheckAndRemoveMatches(Game_t *g);
+static uint32_t GetScoreForCount(const Game_t *g, uint16_t count);
+static void Game_RemoveGroups(Game_t *g, uint32_t marked[BOARD_ROWS]);
+static void Game_GroupTake(uint32_t marked[BOARD_ROWS], uint32_t group[BOARD_ROWS], uint16_t *stack, uint16_t *top, int r, int c);
+static uint8_t Game_GroupShape(const uint32_t group[BOARD_ROWS], int rmin, int rmax);
+static void Game_ScoreGroup(Game_t *g, uint16_t size, uint8_t color, uint8_t shape);
+static void Game_LogEvent(Game_t *g, uint8_t type, uint8_t a, uint8_t b, uint8_t c);
+static void Game_FrameMove(Game_t *g, int from, int to, int c);
+static void Game_ClearCell(Game_t *g, int r, int c);
+static uint32_t Game_Fmix32(uint32_t x);
+
+#define GAME_LINE_MASK(n) ((n) >= 32 ? 0xFFFFFFFFu : (1u << (n)) - 1u) // Біти 0..n-1 для dirty_rows/dirty_cols
+
+/* --- ФОРМИ "ОДИН ОБМІН ДО ТРЬОХ" ---
+ * Кулька прилітає в клітинку t. Лінія утвориться, якщо дві клітинки
+ * форми (зміщення відносно t) мають той самий колір. Форми, що містять
+ * клітинку-джерело, не підходять: після обміну там інший колір. */
+typedef struct {
+    int8_t dr1, dc1;
+    int8_t dr2, dc2;
+} MovePattern_t;
+
+#if !GAME_USE_SWAR // SWAR розгортає обидві таблиці вручну (SWAR_MoveMasks)
+static const MovePattern_t kMovePatterns[6] = {
+    { 0, -2,  0, -1 }, // ..t  (горизонталь, зліва)
+    { 0, -1,  0,  1 }, // .t.  (горизонталь, по центру)
+    { 0,  1,  0,  2 }, // t..  (горизонталь, справа)
+    { -2, 0, -1,  0 }, // вертикаль, зверху
+    { -1, 0,  1,  0 }, // вертикаль, по центру
+    { 1,  0,  2,  0 }, // вертикаль, знизу
+};
+
+// Звідки прилітає кулька: зміщення джерела відносно t і дозволені форми (біт i — kMovePatterns[i])
+typedef struct {
+    int8_t dr, dc;
+    uint8_t patterns;
+} MoveSource_t;
+
+enum { FROM_LEFT, FROM_RIGHT, FROM_ABOVE, FROM_BELOW };
+
+static const MoveSource_t kMoveSources[4] = {
+    [FROM_LEFT]  = { 0, -1, 0x3C },
+    [FROM_RIGHT] = { 0,  1, 0x39 },
+    [FROM_ABOVE] = { -1, 0, 0x27 },
+    [FROM_BELOW] = { 1,  0, 0x0F },
+};
+#endif
+
+#if GAME_USE_BITBOARD
+/* --- БІТБОРД ---
+ * Біт (r * 8 + c) маски кольору встановлений, якщо board[r][c] == колір.
+ * Сусід праворуч — зсув на 1, сусід знизу — зсув на BOARD_COLS. */
+#define BB_CELL(r, c)   ((uint64_t)1 << ((r) * BOARD_COLS + (c)))
+#define BB_H_STARTS     0x3F3F3F3F3F3F3F3FULL // Стовпчики 0..5: c, c+1, c+2 в одному рядку
+
+typedef uint64_t BitBoard_t;
+
+static void BB_Build(const Game_t *g, BitBoard_t masks[GAME_NUM_COLORS + 1]);
+static BitBoard_t BB_Lines(BitBoard_t m);
+static BitBoard_t BB_LinesIn(BitBoard_t m, BitBoard_t h_region, BitBoard_t v_region);
+static BitBoard_t BB_Shift(BitBoard_t m, int dr, int dc);
+static void BB_MoveMasks(const Game_t *g, BitBoard_t *h_moves, BitBoard_t *v_moves);
+#elif GAME_USE_SWAR
+/* --- SWAR ---
+ * Рядок — одне слово uint32_t, клітинка c — тетрада (біти 4c..4c+3).
+ * Множина клітинок рядка — слово з прапорцями в старшому біті тетрад (0x88888888).
+ * Сусід праворуч — зсув слова на 4, сусід знизу — наступне слово;
+ * клітинки за межами поля читаються як 0 (порожні). */
+#define SWAR_FLAGS      0x88888888u
+#define SWAR_LOW3       0x77777777u
+#define SWAR_FLAG(c)    (0x8u << (4 * (c)))
+#define SWAR_H_STARTS   0x00888888u // Стовпчики 0..5: c, c+1, c+2 в одному рядку
+#define SWAR_EQ(a, b)   (~SWAR_NonZero((a) ^ (b)) & SWAR_FLAGS) // Тетради, де a і b рівні
+
+static void SWAR_Build(Game_t *g);
+static uint32_t SWAR_NonZero(uint32_t x);
+static uint32_t SWAR_Row(const Game_t *g, int r);
+static void SWAR_Lines(const Game_t *g, uint32_t h_rows, uint32_t v_cols, uint32_t marked[BOARD_ROWS]);
+static void SWAR_MoveMasks(const Game_t *g, uint32_t h_moves[BOARD_ROWS], uint32_t v_moves[BOARD_ROWS]);
+#else
+static int Game_PatternHit(const Game_t *g, int r, int c, uint8_t color, int from);
+#endif
+
+static void Game_SetCell(Game_t *g, int r, int c, uint8_t color);
+static void Game_PutCell(Game_t *g, int r, int c, uint8_t color);
+static void Game_UiStep(Game_t *g);
+static uint32_t Game_Random(Game_t *g);
 
 /* --- ПУБЛІЧНІ ФУНКЦІЇ --- */
 
-void Game_Init(void) {
-    score = 0;
-    // Заповнюємо поле без анімацій
-    for (int r = 0; r < BOARD_ROWS; r++) {
-        for (int c = 0; c < BOARD_COLS; c++) {
-            board[r][c] = GetValidRandomColor(r, c);
-        }
+// Одноразове налаштування контексту: колбек анімації
+void Game_Setup(Game_t *g, GameUiCallback_t ui_update, void *ui_ctx) {
+    memset(g, 0, sizeof(*g));
+    g->ui_update = ui_update;
+    g->ui_ctx = ui_ctx;
+    g->step_frames = 1;
+    g->rng_state = 1;
+    Game_SetScoreTable(g, NULL);
+#if GAME_RUNTIME_GEOMETRY
+    g->rows = BOARD_ROWS;
+    g->cols = BOARD_COLS;
+    g->num_colors = GAME_NUM_COLORS;
+#endif
+    Game_MarkAllDirty(g);
+}
+
+// Розміри поля й кількість кольорів для наступного Game_Init. Без GAME_RUNTIME_GEOMETRY
+// приймає лише зібрану геометрію — так клієнт може перевірити, з чим працює плата.
+int Game_SetGeometry(Game_t *g, uint8_t rows, uint8_t cols, uint8_t colors) {
+#if GAME_RUNTIME_GEOMETRY
+    if (rows < GAME_MIN_ROWS || rows > BOARD_ROWS || cols < GAME_MIN_COLS || cols > BOARD_COLS ||
+        colors < GAME_MIN_COLORS || colors > GAME_NUM_COLORS) return 0;
+    g->rows = rows;
+    g->cols = cols;
+    g->num_colors = colors;
+    memset(g->board, 0, sizeof(g->board));
+    Game_MarkAllDirty(g);
+    return 1;
+#else
+    (void)g;
+    return rows == BOARD_ROWS && cols == BOARD_COLS && colors == GAME_NUM_COLORS;
+#endif
+}
+
+void Game_Init(Game_t *g, uint32_t seed) {
+    g->score = 0;
+    g->seed = seed;
+    // Перемішуємо біти зерна, щоб сусідні зерна давали різні поля.
+    // 0 переходить лише в 0 — xorshift такого стану не терпить.
+    seed = Game_Fmix32(seed);
+    g->rng_state = seed ? seed : 0x9E3779B9u;
+
+    // Заповнюємо поле без анімацій: один виклик генератора на клітинку.
+    // Праворуч і знизу ще порожньо, тож забороняють лише сусіди зліва та згори.
+    memset(g->board, 0, sizeof(g->board));
+    for (int r = 0; r < GAME_ROWS(g); r++) Game_FillRow(g, r);
+    Game_MarkAllDirty(g);
+    // Game_ForbiddenColors не допускає ліній — перевіряти нічого
+    g->dirty_rows = 0;
+    g->dirty_cols = 0;
+
+    // Поле без жодного ходу трапляється рідко; тоді генеруємо з гарантованим ходом
+    if (!Game_FindMoves(g, NULL, 1)) Game_Shuffle(g);
+}
+
+/* Нове поле без ліній і щонайменше з одним ходом; рахунок не змінюється.
+ * Це не перестановка наявних кульок, а нова генерація: спершу закладаємо
+ * хід "k k . k" у випадковому місці, решту заповнюємо з Game_ForbiddenColors.
+ * Порядок — рядок ходу, рядки над ним знизу вгору, рядки під ним згори вниз:
+ * так у кожної клітинки готові сусіди щонайбільше з двох боків, і заборонених
+ * кольорів не більше двох. Завжди GAME_ROWS * GAME_COLS викликів генератора. */
+void Game_Shuffle(Game_t *g) {
+    int r = (int)(((Game_Random(g) >> 16) * GAME_ROWS(g)) >> 16);
+    int c = (int)(((Game_Random(g) >> 16) * (GAME_COLS(g) - 3)) >> 16);
+    uint8_t k = Game_PickColor(g, 0);
+
+    memset(g->board, 0, sizeof(g->board));
+    g->board[r][c] = k;
+    g->board[r][c + 1] = k;
+    g->board[r][c + 3] = k; // Обмін (r, c+2) <-> (r, c+3) дає лінію
+
+    Game_FillRow(g, r);
+    for (int i = r - 1; i >= 0; i--) Game_FillRow(g, i);
+    for (int i = r + 1; i < GAME_ROWS(g); i++) Game_FillRow(g, i);
+
+    Game_MarkAllDirty(g);
+    g->dirty_rows = 0;
+    g->dirty_cols = 0;
+}
+
+void Game_SetStepFrames(Game_t *g, uint8_t enabled) {
+    g->step_frames = enabled;
+}
+
+void Game_SetRefillNoMatch(Game_t *g, uint8_t enabled) {
+    g->refill_no_match = enabled;
+}
+
+void Game_SetScoreTable(Game_t *g, const uint16_t table[GAME_SCORE_TABLE_SIZE]) {
+    static const uint16_t defaults[GAME_SCORE_TABLE_SIZE] = {
+        GAME_SCORE_DEFAULT_3, GAME_SCORE_DEFAULT_4, GAME_SCORE_DEFAULT_5
+    };
+    memcpy(g->score_table, table ? table : defaults, sizeof(g->score_table));
+}
+
+// Буфер належить викликачу. За один крок анімації (між викликами колбека) пишеться
+// не більше GAME_MAX_STEP_EVENTS подій.
+void Game_SetEventLog(Game_t *g, GameEvent_t *buf, uint16_t capacity) {
+    g->events = buf;
+    g->event_cap = buf ? capacity : 0;
+    Game_ClearEvents(g);
+}
+
+void Game_ClearEvents(Game_t *g) {
+    g->event_count = 0;
+    g->event_overflow = 0;
+    g->event_group = 0;
+}
+
+/* Ключ (r, c, колір) — дві половини з фіналізатора murmur3 замість таблиці на
+ * 3.5 КБ: формула однакова для будь-якої геометрії, і клієнт рахує її сам.
+ * Порожня клітинка нічого не додає, тож згорання — один XOR. */
+uint64_t Game_ZobristKey(uint8_t r, uint8_t c, uint8_t color) {
+    if (color == 0) return 0;
+    uint32_t x = ((uint32_t)r << 9) | ((uint32_t)c << 4) | color;
+    return ((uint64_t)Game_Fmix32(x + 0x7F4A7C15u) << 32) | Game_Fmix32(x + 0x9E3779B9u);
+}
+
+uint32_t Game_Fingerprint(const Game_t *g) {
+    return (uint32_t)(g->hash >> 32) ^ (uint32_t)g->hash;
+}
+
+// Також перераховує hash: після зміни g->board поза рушієм відбиток інакше застаріє
+void Game_MarkAllDirty(Game_t *g) {
+    g->hash = 0;
+    for (int r = 0; r < GAME_ROWS(g); r++) {
+        for (int c = 0; c < GAME_COLS(g); c++) g->hash ^= Game_ZobristKey((uint8_t)r, (uint8_t)c, g->board[r][c]);
     }
+#if GAME_USE_BITBOARD
+    BB_Build(g, g->color_masks);
+#elif GAME_USE_SWAR
+    SWAR_Build(g);
+#endif
+    g->dirty_rows = GAME_LINE_MASK(GAME_ROWS(g));
+    g->dirty_cols = GAME_LINE_MASK(GAME_COLS(g));
 }
 
-uint8_t Game_Swap(uint8_t r1, uint8_t c1, uint8_t r2, uint8_t c2) {
-    if (r1 >= BOARD_ROWS || c1 >= BOARD_COLS || r2 >= BOARD_ROWS || c2 >= BOARD_COLS) return 0;
+uint8_t Game_Swap(Game_t *g, uint8_t r1, uint8_t c1, uint8_t r2, uint8_t c2) {
+    if (r1 >= GAME_ROWS(g) || c1 >= GAME_COLS(g) || r2 >= GAME_ROWS(g) || c2 >= GAME_COLS(g)) return 0;
 
     int diff_r = abs((int)r1 - (int)r2);
     int diff_c = abs((int)c1 - (int)c2);
     if ((diff_r + diff_c) != 1) return 0;
 
-    // Тимчасовий обмін
-    uint8_t temp = board[r1][c1];
-    board[r1][c1] = board[r2][c2];
-    board[r2][c2] = temp;
+    // Тимчасовий обмін; hash оновлюється лише для вдалого (XOR переставний, тож і після згорання)
+    uint8_t temp = g->board[r1][c1];
+    uint8_t other = g->board[r2][c2];
+    Game_PutCell(g, r1, c1, other);
+    Game_PutCell(g, r2, c2, temp);
+
+    // Подія обміну має передувати згоранню; якщо ліній немає, її прибираємо
+    uint16_t logged = g->event_count;
+    if (diff_r) Game_LogEvent(g, GAME_EV_SWAP, r1 < r2 ? r1 : r2, c1, 1);
+    else Game_LogEvent(g, GAME_EV_SWAP, r1, c1 < c2 ? c1 : c2, 0);
 
-    if (Game_CheckAndRemoveMatches()) {
+    if (Game_CheckAndRemoveMatches(g)) {
         // Збіг знайдено і видалено (замінено на 0).
         // Повертаємо 1. Сама анімація і гравітація запускаються з main.c
+        g->hash ^= Game_ZobristKey(r1, c1, temp) ^ Game_ZobristKey(r1, c1, other) ^
+                   Game_ZobristKey(r2, c2, other) ^ Game_ZobristKey(r2, c2, temp);
         return 1;
     } else {
         // Скасування обміну
-        board[r2][c2] = board[r1][c1];
-        board[r1][c1] = temp;
+        Game_PutCell(g, r2, c2, other);
+        Game_PutCell(g, r1, c1, temp);
+        if (g->event_count > logged) g->event_count = logged;
         return 0;
     }
 }
 
-uint8_t Game_HasPossibleMoves(void) {
-    for (int r = 0; r < BOARD_ROWS; r++) {
-        for (int c = 0; c < BOARD_COLS; c++) {
-            if (c < BOARD_COLS - 1) {
-                uint8_t temp = board[r][c];
-                board[r][c] = board[r][c+1];
-                board[r][c+1] = temp;
-                int has_match = Game_IsMatchPresent();
-                board[r][c+1] = board[r][c];
-                board[r][c] = temp;
-                if (has_match) return 1;
-            }
-            if (r < BOARD_ROWS - 1) {
-                uint8_t temp = board[r][c];
-                board[r][c] = board[r+1][c];
-                board[r+1][c] = temp;
-                int has_match = Game_IsMatchPresent();
-                board[r+1][c] = board[r][c];
-                board[r][c] = temp;
-                if (has_match) return 1;
+uint8_t Game_HasPossibleMoves(const Game_t *g) {
+    // Лінія вже є на полі — будь-який обмін дає збіг
+    if (Game_IsMatchPresent(g)) return 1;
+    return Game_FindMoves(g, NULL, 1);
+}
+
+// Шукає обміни, що утворюють лінію, у порядку обходу поля (рядок, стовпчик; спершу горизонтальний).
+// Записує до max_moves ходів у moves (може бути NULL) і повертає їх кількість.
+// max_moves = 1 — перший хід (підказка), GAME_MAX_MOVES — усі ходи.
+uint16_t Game_FindMoves(const Game_t *g, GameMove_t *moves, uint16_t max_moves) {
+    uint16_t found = 0;
+    if (max_moves == 0) return 0;
+
+#if GAME_USE_BITBOARD
+    BitBoard_t h_moves, v_moves;
+    BB_MoveMasks(g, &h_moves, &v_moves);
+    if (!h_moves && !v_moves) return 0;
+#elif GAME_USE_SWAR
+    uint32_t h_moves[BOARD_ROWS], v_moves[BOARD_ROWS], any = 0;
+    SWAR_MoveMasks(g, h_moves, v_moves);
+    for (int r = 0; r < BOARD_ROWS; r++) any |= h_moves[r] | v_moves[r];
+    if (!any) return 0;
+#endif
+
+    for (int r = 0; r < GAME_ROWS(g); r++) {
+        for (int c = 0; c < GAME_COLS(g); c++) {
+            for (int down = 0; down < 2; down++) {
+                int r2 = r + down;
+                int c2 = c + !down;
+                if (r2 >= GAME_ROWS(g) || c2 >= GAME_COLS(g)) continue;
+
+#if GAME_USE_BITBOARD
+                int legal = ((down ? v_moves : h_moves) & BB_CELL(r, c)) != 0;
+#elif GAME_USE_SWAR
+                int legal = ((down ? v_moves[r] : h_moves[r]) & SWAR_FLAG(c)) != 0;
+#else
+                uint8_t a = g->board[r][c];
+                uint8_t b = g->board[r2][c2];
+                int legal = 0;
+                if (a != b) {
+                    // a переходить у (r2, c2), b — у (r, c)
+                    legal = (a != 0 && Game_PatternHit(g, r2, c2, a, down ? FROM_ABOVE : FROM_LEFT)) ||
+                            (b != 0 && Game_PatternHit(g, r, c, b, down ? FROM_BELOW : FROM_RIGHT));
+                }
+#endif
+                if (!legal) continue;
+
+                if (moves) {
+                    moves[found].r1 = (uint8_t)r;
+                    moves[found].c1 = (uint8_t)c;
+                    moves[found].r2 = (uint8_t)r2;
+                    moves[found].c2 = (uint8_t)c2;
+                }
+                if (++found >= max_moves) return found;
             }
         }
     }
-    return 0;
+    return found;
 }
 
 // Головний цикл гравітації (Тепер ПУБЛІЧНИЙ, викликається з main.c)
-void Game_RunGravityLoop(void) {
+void Game_RunGravityLoop(Game_t *g) {
     int matches_found;
     do {
-        // 1. Покрокове падіння вже існуючих кубиків
-        int moved;
-        do {
-            moved = Game_GravityStep();
-            if (moved) UI_Update_Step();
-        } while (moved);
-
-        // 2. Потокова генерація і падіння нових кубиків згори
-        int needs_fill;
-        do {
-            needs_fill = 0;
-
-            // Заповнюємо верхній ряд, якщо там порожньо
-            for (int c = 0; c < BOARD_COLS; c++) {
-                if (board[0][c] == 0) {
-                    board[0][c] = (rand() % 6) + 1;
-                    needs_fill = 1;
-                }
-            }
-
-            if (needs_fill) {
-                UI_Update_Step(); // З'явилися нові
-            }
+        // 1-2. Падіння і поява нових кубиків згори — один прохід по кожному стовпчику
+        GameFall_t fall;
+        Game_CollapseAndRefill(g, &fall);
 
-            // Робимо один крок падіння для всіх, щоб звільнити верхній ряд
-            if (Game_GravityStep()) {
-                UI_Update_Step(); // Впали на 1 крок
-                needs_fill = 1; // Продовжуємо, бо ще є рух
-            }
-        } while (needs_fill);
+        if (g->step_frames) {
+            Game_ShowFallFrames(g, &fall);
+        } else if (fall.max_fall || fall.max_spawn) {
+            Game_UiStep(g); // Одразу кінцевий стан
+        }
 
         // 3. Після того, як все впало, перевіряємо, чи не утворились нові "3-в-ряд" (комбо)
-        matches_found = Game_CheckAndRemoveMatches();
+        matches_found = Game_CheckAndRemoveMatches(g);
         if (matches_found) {
-            UI_Update_Step(); // Показуємо згорання нових кубиків
+            Game_UiStep(g); // Показуємо згорання нових кубиків
         }
     } while (matches_found);
 }
 
 /* --- ПРИВАТНІ ФУНКЦІЇ --- */
 
-// Виконує РІВНО ОДИН крок падіння (всі кубики, під якими порожньо, падають на 1 клітинку)
-static int Game_GravityStep(void) {
-    int moved = 0;
-    for (int c = 0; c < BOARD_COLS; c++) {
-        // Йдемо знизу вгору, щоб кубики не пролітали все поле за один прохід
-        for (int r = BOARD_ROWS - 2; r >= 0; r--) {
-            if (board[r][c] != 0 && board[r+1][c] == 0) {
-                board[r+1][c] = board[r][c];
-                board[r][c] = 0;
-                moved = 1;
+// Стискає кожен стовпчик донизу за один прохід, запам'ятовуючи висоту падіння кожної кульки,
+// і заповнює порожні клітинки згори новими кульками.
+static void Game_CollapseAndRefill(Game_t *g, GameFall_t *fall) {
+    fall->max_fall = 0;
+    fall->max_spawn = 0;
+
+    for (int c = 0; c < GAME_COLS(g); c++) {
+        int w = GAME_ROWS(g) - 1; // Куди ляже наступна кулька
+        for (int r = GAME_ROWS(g) - 1; r >= 0; r--) {
+            uint8_t color = g->board[r][c];
+            if (color == 0) continue;
+            if (w != r) {
+                Game_SetCell(g, w, c, color);
+                Game_SetCell(g, r, c, 0);
+                if (!g->step_frames) Game_LogEvent(g, GAME_EV_FALL, (uint8_t)r, (uint8_t)w, (uint8_t)c);
             }
+            fall->fall_dist[w][c] = (uint8_t)(w - r);
+            if (w - r > fall->max_fall) fall->max_fall = (uint8_t)(w - r);
+            w--;
+        }
+        fall->spawn_count[c] = (uint8_t)(w + 1);
+        if (fall->spawn_count[c] > fall->max_spawn) fall->max_spawn = fall->spawn_count[c];
+    }
+
+    // Порядок викликів генератора — як у покроковій версії: на i-й ітерації верхній ряд
+    // заповнюється зліва направо в тих стовпчиках, де ще потрібні нові кульки.
+    for (int i = 1; i <= fall->max_spawn; i++) {
+        for (int c = 0; c < GAME_COLS(g); c++) {
+            if (fall->spawn_count[c] < i) continue;
+            int r = fall->spawn_count[c] - i;
+            uint32_t forbidden = g->refill_no_match ? Game_ForbiddenColors(g, r, c) : 0;
+            Game_SetCell(g, r, c, Game_PickColor(g, forbidden));
+            fall->fall_dist[r][c] = (uint8_t)r;
+            if (!g->step_frames) Game_LogEvent(g, GAME_EV_SPAWN, (uint8_t)r, (uint8_t)c, g->board[r][c]);
         }
     }
-    return moved;
 }
 
-static int Game_CheckAndRemoveMatches(void) {
-    uint8_t marked[BOARD_ROWS][BOARD_COLS] = {0};
-    int found_match = 0;
+// Відтворює з запису ті самі кадри, що давало покрокове падіння на 1 рядок:
+// спершу падають наявні кульки, потім нові з'являються у верхньому ряду й опускаються.
+// Кожен кадр — кілька зсувів на 1 рядок від попереднього, і саме вони йдуть у журнал.
+static void Game_ShowFallFrames(Game_t *g, const GameFall_t *fall) {
+    uint8_t final_board[BOARD_ROWS][BOARD_COLS];
+    memcpy(final_board, g->board, sizeof(final_board));
+
+    // Стан до падіння: наявні кульки на старих місцях, нових ще немає
+    memset(g->board, 0, sizeof(g->board));
+    for (int c = 0; c < GAME_COLS(g); c++) {
+        for (int r = fall->spawn_count[c]; r < GAME_ROWS(g); r++) {
+            g->board[r - fall->fall_dist[r][c]][c] = final_board[r][c];
+        }
+    }
+
+    // Кадр t: кулька, що падає на d >= t рядків, опускається ще на 1.
+    // Знизу вгору — щоб клітинка під кулькою вже звільнилася.
+    for (int t = 1; t <= fall->max_fall; t++) {
+        for (int c = 0; c < GAME_COLS(g); c++) {
+            for (int r = GAME_ROWS(g) - 1; r >= fall->spawn_count[c]; r--) {
+                int d = fall->fall_dist[r][c];
+                if (d >= t) Game_FrameMove(g, r - d + t - 1, r - d + t, c);
+            }
+        }
+        Game_UiStep(g);
+    }
+
+    // На i-й ітерації з'являється i-та нова кулька, після чого (якщо є куди) усі нові падають на 1 рядок
+    for (int i = 1; i <= fall->max_spawn; i++) {
+        for (int c = 0; c < GAME_COLS(g); c++) {
+            int k = fall->spawn_count[c];
+            if (k < i) continue;
+            g->board[0][c] = final_board[k - i][c];
+            Game_LogEvent(g, GAME_EV_SPAWN, 0, (uint8_t)c, g->board[0][c]);
+        }
+        Game_UiStep(g);
+        if (i == fall->max_spawn) break;
+
+        for (int c = 0; c < GAME_COLS(g); c++) {
+            if (fall->spawn_count[c] <= i) continue; // Нові кульки стовпчика вже на місцях
+            for (int j = 1; j <= i; j++) Game_FrameMove(g, i - j, i - j + 1, c);
+        }
+        Game_UiStep(g);
+    }
+}
+
+#if GAME_USE_BITBOARD
+static int Game_CheckAndRemoveMatches(Game_t *g) {
+    BitBoard_t marked = 0;
+    BitBoard_t h_region = 0;
+#if !GAME_INCREMENTAL_MATCH
+    // Без інкрементальної перевірки — усе поле
+    g->dirty_rows = GAME_LINE_MASK(GAME_ROWS(g));
+    g->dirty_cols = GAME_LINE_MASK(GAME_COLS(g));
+#endif
+
+    // Горизонтальні лінії — лише в брудних рядках, вертикальні — лише в брудних стовпчиках
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        if (g->dirty_rows & (1u << r)) h_region |= (BitBoard_t)0xFF << (r * BOARD_COLS);
+    }
+    BitBoard_t v_region = (BitBoard_t)(g->dirty_cols & 0xFF) * 0x0101010101010101ULL;
+    g->dirty_rows = 0;
+    g->dirty_cols = 0;
+
+    for (int k = 1; k <= GAME_NUM_COLORS; k++) {
+        marked |= BB_LinesIn(g->color_masks[k], h_region, v_region);
+    }
+    if (!marked) return 0;
+
+    // Видалення не створює ліній, тому клітинки не позначаються брудними
+    uint32_t rows[BOARD_ROWS];
+    for (int r = 0; r < BOARD_ROWS; r++) rows[r] = (uint32_t)(marked >> (r * BOARD_COLS)) & 0xFFu;
+    Game_RemoveGroups(g, rows);
+    for (int k = 1; k <= GAME_NUM_COLORS; k++) {
+        g->color_masks[k] &= ~marked;
+    }
+    g->color_masks[0] |= marked;
+    return 1;
+}
+#elif GAME_USE_SWAR
+static int Game_CheckAndRemoveMatches(Game_t *g) {
+    uint32_t marked[BOARD_ROWS];
+    uint32_t cells[BOARD_ROWS]; // marked по біту на клітинку, для Game_RemoveGroups
+    uint32_t any = 0;
+#if !GAME_INCREMENTAL_MATCH
+    // Без інкрементальної перевірки — усе поле
+    g->dirty_rows = GAME_LINE_MASK(GAME_ROWS(g));
+    g->dirty_cols = GAME_LINE_MASK(GAME_COLS(g));
+#endif
+
+    SWAR_Lines(g, g->dirty_rows, g->dirty_cols, marked);
+    g->dirty_rows = 0;
+    g->dirty_cols = 0;
+    for (int r = 0; r < BOARD_ROWS; r++) any |= marked[r];
+    if (!any) return 0;
 
+    // Видалення не створює ліній, тому клітинки не позначаються брудними
     for (int r = 0; r < BOARD_ROWS; r++) {
-        for (int c = 0; c <= BOARD_COLS - 3; c++) {
-            uint8_t color = board[r][c];
+        uint32_t x = marked[r] >> 3; // Прапорець стовпчика c — біт 4c; стискаємо до біта c
+        x = (x | (x >> 3)) & 0x03030303u;
+        x = (x | (x >> 6)) & 0x000F000Fu;
+        cells[r] = (x | (x >> 12)) & 0xFFu;
+    }
+    Game_RemoveGroups(g, cells);
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        g->rows[r] &= ~((marked[r] >> 3) * 0xFu); // Прапорець -> уся тетрада
+    }
+    return 1;
+}
+#else
+static int Game_CheckAndRemoveMatches(Game_t *g) {
+    uint32_t marked[BOARD_ROWS] = {0}; // Біт c — клітинка (r, c) у лінії
+    int found_match = 0;
+#if !GAME_INCREMENTAL_MATCH
+    // Без інкрементальної перевірки — усе поле
+    g->dirty_rows = GAME_LINE_MASK(GAME_ROWS(g));
+    g->dirty_cols = GAME_LINE_MASK(GAME_COLS(g));
+#endif
+
+    for (int r = 0; r < GAME_ROWS(g); r++) {
+        if (!(g->dirty_rows & (1u << r))) continue;
+        for (int c = 0; c <= GAME_COLS(g) - 3; c++) {
+            uint8_t color = g->board[r][c];
             if (color == 0) continue;
-            if (board[r][c+1] == color && board[r][c+2] == color) {
+            if (g->board[r][c+1] == color && g->board[r][c+2] == color) {
                 found_match = 1;
-                marked[r][c] = marked[r][c+1] = marked[r][c+2] = 1;
+                marked[r] |= 7u << c;
             }
         }
     }
 
-    for (int c = 0; c < BOARD_COLS; c++) {
-        for (int r = 0; r <= BOARD_ROWS - 3; r++) {
-            uint8_t color = board[r][c];
+    for (int c = 0; c < GAME_COLS(g); c++) {
+        if (!(g->dirty_cols & (1u << c))) continue;
+        for (int r = 0; r <= GAME_ROWS(g) - 3; r++) {
+            uint8_t color = g->board[r][c];
             if (color == 0) continue;
-            if (board[r+1][c] == color && board[r+2][c] == color) {
+            if (g->board[r+1][c] == color && g->board[r+2][c] == color) {
                 found_match = 1;
-                marked[r][c] = marked[r+1][c] = marked[r+2][c] = 1;
+                marked[r] |= 1u << c;
+                marked[r+1] |= 1u << c;
+                marked[r+2] |= 1u << c;
             }
         }
     }
+    g->dirty_rows = 0;
+    g->dirty_cols = 0;
 
-    if (found_match) {
-        uint8_t count = 0;
-        for (int r = 0; r < BOARD_ROWS; r++) {
-            for (int c = 0; c < BOARD_COLS; c++) {
-                if (marked[r][c]) {
-                    board[r][c] = 0;
-                    count++;
+    if (found_match) Game_RemoveGroups(g, marked);
+    return found_match;
+}
+#endif
+
+static void Game_SetCell(Game_t *g, int r, int c, uint8_t color) {
+    g->hash ^= Game_ZobristKey((uint8_t)r, (uint8_t)c, g->board[r][c]) ^ Game_ZobristKey((uint8_t)r, (uint8_t)c, color);
+    Game_PutCell(g, r, c, color);
+}
+
+// Єдине місце зміни клітинки всередині рушія: тримає маски й брудні рядки/стовпчики в актуальному стані.
+// hash не чіпає — це робить Game_SetCell або викликач (Game_Swap)
+static void Game_PutCell(Game_t *g, int r, int c, uint8_t color) {
+#if GAME_USE_BITBOARD
+    BitBoard_t bit = BB_CELL(r, c);
+    if (g->board[r][c] <= GAME_NUM_COLORS) g->color_masks[g->board[r][c]] &= ~bit;
+    g->color_masks[color] |= bit;
+#elif GAME_USE_SWAR
+    g->rows[r] = (g->rows[r] & ~(0xFu << (4 * c))) | ((uint32_t)color << (4 * c));
+#endif
+    g->board[r][c] = color;
+    g->dirty_rows |= 1u << r;
+    g->dirty_cols |= 1u << c;
+}
+
+static void Game_UiStep(Game_t *g) {
+    if (g->ui_update) g->ui_update(g, g->ui_ctx);
+}
+
+// Група містить щонайменше одну лінію, тож count >= 3
+static uint32_t GetScoreForCount(const Game_t *g, uint16_t count) {
+    if (count == 3) return g->score_table[0];
+    if (count == 4) return g->score_table[1];
+    return g->score_table[2];
+}
+
+/* Розбиває позначені клітинки (біт c у marked[r]; масив витрачається) на групи —
+ * зв'язні по сторонах області одного кольору — і прибирає їх по черзі: GROUP, очки
+ * за розмір групи, CLEAR кожної кульки. Обхід у глибину з явним стеком, кожна
+ * позначена клітинка потрапляє в стек рівно раз. Перша клітинка групи в порядку
+ * рядків лежить у її верхньому рядку, тож рядки групи — від r0 до rmax. */
+static void Game_RemoveGroups(Game_t *g, uint32_t marked[BOARD_ROWS]) {
+    uint16_t stack[BOARD_ROWS * BOARD_COLS];
+    uint32_t group[BOARD_ROWS] = {0}; // Клітинки поточної групи; між групами порожній
+
+    for (int r0 = 0; r0 < GAME_ROWS(g); r0++) {
+        for (int c0 = 0; marked[r0] && c0 < GAME_COLS(g); c0++) {
+            if (!(marked[r0] & (1u << c0))) continue;
+            uint8_t color = g->board[r0][c0];
+            uint16_t size = 0, top = 0;
+            int rmax = r0;
+
+            Game_GroupTake(marked, group, stack, &top, r0, c0);
+            while (top) {
+                int r = stack[--top] / BOARD_COLS;
+                int c = stack[top] % BOARD_COLS;
+                size++;
+                if (r > rmax) rmax = r;
+                // Сусіди ліворуч і праворуч: біт за межами рядка в marked завжди 0
+                uint32_t bit = 1u << c;
+                uint32_t take = marked[r] & ((bit >> 1) | (bit << 1));
+                if ((take & (bit >> 1)) && g->board[r][c - 1] == color) Game_GroupTake(marked, group, stack, &top, r, c - 1);
+                if ((take & (bit << 1)) && g->board[r][c + 1] == color) Game_GroupTake(marked, group, stack, &top, r, c + 1);
+                if (r > 0 && (marked[r - 1] & bit) && g->board[r - 1][c] == color) Game_GroupTake(marked, group, stack, &top, r - 1, c);
+                if (r + 1 < GAME_ROWS(g) && (marked[r + 1] & bit) && g->board[r + 1][c] == color) Game_GroupTake(marked, group, stack, &top, r + 1, c);
+            }
+
+            Game_ScoreGroup(g, size, color, Game_GroupShape(group, r0, rmax));
+            for (int r = r0; r <= rmax; r++) {
+                for (int c = 0; group[r]; c++) {
+                    if (!(group[r] & (1u << c))) continue;
+                    Game_ClearCell(g, r, c);
+                    group[r] &= ~(1u << c);
                 }
             }
+            g->event_group++;
         }
-        score += GetScoreForCount(count);
     }
-    return found_match;
 }
 
-static uint32_t GetScoreForCount(uint8_t count) {
-    if (count == 3) return 30;
-    if (count == 4) return 60;
-    if (count >= 5) return 100;
-    return count * 10;
+// Переносить клітинку з позначених у поточну групу й кладе її в стек обходу
+static void Game_GroupTake(uint32_t marked[BOARD_ROWS], uint32_t group[BOARD_ROWS], uint16_t *stack, uint16_t *top, int r, int c) {
+    marked[r] &= ~(1u << c);
+    group[r] |= 1u << c;
+    stack[(*top)++] = (uint16_t)(r * BOARD_COLS + c);
 }
 
-static uint8_t GetValidRandomColor(int r, int c) {
-    uint8_t color;
-    int is_valid;
-    do {
-        color = (rand() % 6) + 1;
-        is_valid = 1;
-        if (c >= 2 && board[r][c-1] == color && board[r][c-2] == color) is_valid = 0;
-        if (r >= 2 && board[r-1][c] == color && board[r-2][c] == color) is_valid = 0;
-    } while (!is_valid);
+/* Форма групи за масками її рядків. Дві лінії, що перетинаються, — це один рядок
+ * з кількома кульками (горизонталь), а решта рядків мають по одній кульці в тому
+ * самому стовпчику (вертикаль). Інакше — одна лінія або GAME_SHAPE_OTHER. */
+static uint8_t Game_GroupShape(const uint32_t group[BOARD_ROWS], int rmin, int rmax) {
+    uint32_t h_line = 0, column = 0;
+    int hr = -1;
+    if (rmin == rmax) return GAME_SHAPE_LINE;
+
+    for (int r = rmin; r <= rmax; r++) {
+        uint32_t m = group[r];
+        if (m & (m - 1)) {
+            if (hr >= 0) return GAME_SHAPE_OTHER; // Дві горизонталі
+            hr = r;
+            h_line = m;
+        } else if (column && m != column) {
+            return GAME_SHAPE_OTHER;
+        } else {
+            column = m;
+        }
+    }
+    if (hr < 0) return GAME_SHAPE_LINE; // Вертикаль
+    if (!(h_line & column)) return GAME_SHAPE_OTHER;
+
+    int v_inner = hr != rmin && hr != rmax;                              // Горизонталь посередині вертикалі
+    int h_inner = (h_line & (column << 1)) && (h_line & (column >> 1)); // Вертикаль посередині горизонталі
+    if (v_inner && h_inner) return GAME_SHAPE_CROSS;
+    return (v_inner || h_inner) ? GAME_SHAPE_T : GAME_SHAPE_L;
+}
+
+// Нараховує очки за одну групу; її кульки далі йдуть у журнал з тим самим номером
+static void Game_ScoreGroup(Game_t *g, uint16_t size, uint8_t color, uint8_t shape) {
+    uint32_t delta = GetScoreForCount(g, size);
+    g->score += delta;
+    Game_LogEvent(g, GAME_EV_GROUP, (uint8_t)(size > 255 ? 255 : size), (uint8_t)((shape << 4) | color), (uint8_t)g->event_group);
+    Game_LogEvent(g, GAME_EV_SCORE, (uint8_t)(delta >> 16), (uint8_t)(delta >> 8), (uint8_t)delta);
+}
+
+// Після переповнення нові події відкидаються: інакше журнал мав би пропуски посередині
+static void Game_LogEvent(Game_t *g, uint8_t type, uint8_t a, uint8_t b, uint8_t c) {
+    if (!g->events) return;
+    if (g->event_count >= g->event_cap) {
+        g->event_overflow = 1;
+        return;
+    }
+    GameEvent_t *e = &g->events[g->event_count++];
+    e->type = type;
+    e->a = a;
+    e->b = b;
+    e->c = c;
+}
+
+// Згорання клітинки: маски бекенд оновлює сам
+static void Game_ClearCell(Game_t *g, int r, int c) {
+    g->hash ^= Game_ZobristKey((uint8_t)r, (uint8_t)c, g->board[r][c]);
+    g->board[r][c] = 0;
+    Game_LogEvent(g, GAME_EV_CLEAR, (uint8_t)r, (uint8_t)c, (uint8_t)g->event_group);
+}
+
+// Кадр анімації падіння: маски вже в кінцевому стані, тож міняється лише board
+static void Game_FrameMove(Game_t *g, int from, int to, int c) {
+    g->board[to][c] = g->board[from][c];
+    g->board[from][c] = 0;
+    Game_LogEvent(g, GAME_EV_FALL, (uint8_t)from, (uint8_t)to, (uint8_t)c);
+}
+
+/* --- ГЕНЕРАТОР ---
+ * xorshift32: лише зсуви та XOR над uint32_t, тож послідовність однакова
+ * на МК і на хості. Стан зберігається разом зі слотом гри. */
+// Фіналізатор murmur3: взаємно однозначне перемішування бітів, 0 -> 0
+static uint32_t Game_Fmix32(uint32_t x) {
+    x ^= x >> 16; x *= 0x85EBCA6Bu;
+    x ^= x >> 13; x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint32_t Game_Random(Game_t *g) {
+    uint32_t x = g->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g->rng_state = x;
+    return x;
+}
+
+#define GAME_ALL_COLORS(g) ((1u << (GAME_COLORS(g) + 1)) - 2u) // Біти 1..GAME_COLORS
+
+/* Кольори, що доповнили б до лінії з трьох пару сусідів (r, c) у будь-якій
+ * з шести форм; біт k — колір k. Порожні сусіди дають лише біт 0 — його відкидає
+ * Game_PickColor. Клітинки, які ще заповнюватимуться, мають бути порожніми.
+ * При заповненні поля готові сусіди щонайбільше з двох боків — до двох кольорів.
+ * При дозаповненні (refill_no_match) над клітинкою порожньо, і форм чотири: пара
+ * зліва, середина, пара справа, пара знизу. Перші три дають лише кольори лівого
+ * й правого сусіда, тож разом до трьох кольорів. */
+static uint32_t Game_ForbiddenColors(const Game_t *g, int r, int c) {
+    uint32_t forbidden = 0;
+    if (c >= 2 && g->board[r][c-1] == g->board[r][c-2]) forbidden |= 1u << g->board[r][c-1];
+    if (c >= 1 && c + 1 < GAME_COLS(g) && g->board[r][c-1] == g->board[r][c+1]) forbidden |= 1u << g->board[r][c-1];
+    if (c + 2 < GAME_COLS(g) && g->board[r][c+1] == g->board[r][c+2]) forbidden |= 1u << g->board[r][c+1];
+    if (r >= 2 && g->board[r-1][c] == g->board[r-2][c]) forbidden |= 1u << g->board[r-1][c];
+    if (r >= 1 && r + 1 < GAME_ROWS(g) && g->board[r-1][c] == g->board[r+1][c]) forbidden |= 1u << g->board[r-1][c];
+    if (r + 2 < GAME_ROWS(g) && g->board[r+1][c] == g->board[r+2][c]) forbidden |= 1u << g->board[r+1][c];
+    return forbidden;
+}
+
+// Порожні клітинки рядка зліва направо
+static void Game_FillRow(Game_t *g, int r) {
+    for (int c = 0; c < GAME_COLS(g); c++) {
+        if (g->board[r][c] == 0) g->board[r][c] = Game_PickColor(g, Game_ForbiddenColors(g, r, c));
+    }
+}
+
+/* Рівномірно один із дозволених кольорів за один виклик генератора: номер серед
+ * дозволених — зі старших 16 біт множенням замість ділення (на M0 немає UDIV).
+ * Без заборон це той самий колір, що ((x >> 16) * GAME_COLORS >> 16) + 1.
+ * Якщо заборонено все, лінії не уникнути: обирає з усіх. Так буває лише при
+ * дозаповненні з 3 кольорами — там refill_no_match найкраще зусилля, а не гарантія. */
+static uint8_t Game_PickColor(Game_t *g, uint32_t forbidden) {
+    uint32_t allowed = GAME_ALL_COLORS(g) & ~forbidden;
+    if (allowed == 0) allowed = GAME_ALL_COLORS(g);
+
+    uint32_t n = 0;
+    for (uint32_t m = allowed; m; m &= m - 1) n++;
+    uint32_t k = ((Game_Random(g) >> 16) * n) >> 16;
+
+    uint8_t color = 1;
+    for (;; color++) {
+        if (((allowed >> color) & 1u) && k-- == 0) break;
+    }
     return color;
 }
 
-static int Game_IsMatchPresent(void) {
+#if GAME_USE_BITBOARD
+int Game_IsMatchPresent(const Game_t *g) {
+    for (int k = 1; k <= GAME_NUM_COLORS; k++) {
+        if (BB_Lines(g->color_masks[k])) return 1;
+    }
+    return 0;
+}
+
+// Маски кольорів з масиву board (індекс 0 — порожні клітинки)
+static void BB_Build(const Game_t *g, BitBoard_t masks[GAME_NUM_COLORS + 1]) {
+    memset(masks, 0, sizeof(BitBoard_t) * (GAME_NUM_COLORS + 1));
     for (int r = 0; r < BOARD_ROWS; r++) {
-        for (int c = 0; c <= BOARD_COLS - 3; c++) {
-            uint8_t color = board[r][c];
-            if (color == 0) continue;
-            if (board[r][c+1] == color && board[r][c+2] == color) return 1;
+        for (int c = 0; c < BOARD_COLS; c++) {
+            uint8_t color = g->board[r][c];
+            if (color <= GAME_NUM_COLORS) masks[color] |= BB_CELL(r, c);
         }
     }
+}
+
+// Усі клітинки маски, що належать горизонтальній або вертикальній лінії з 3+ кульок
+static BitBoard_t BB_Lines(BitBoard_t m) {
+    return BB_LinesIn(m, ~(BitBoard_t)0, ~(BitBoard_t)0);
+}
+
+// Те саме, але горизонтальні лінії починаються лише в h_region, вертикальні — лише в v_region
+static BitBoard_t BB_LinesIn(BitBoard_t m, BitBoard_t h_region, BitBoard_t v_region) {
+    BitBoard_t h = m & (m >> 1) & (m >> 2) & BB_H_STARTS & h_region;
+    BitBoard_t v = m & (m >> BOARD_COLS) & (m >> (2 * BOARD_COLS)) & v_region;
+    return h | (h << 1) | (h << 2) | v | (v << BOARD_COLS) | (v << (2 * BOARD_COLS));
+}
+
+// Біт (r, c) результату — біт (r + dr, c + dc) маски m; клітинки за межами поля дають 0
+static BitBoard_t BB_Shift(BitBoard_t m, int dr, int dc) {
+    int k = dr * BOARD_COLS + dc;
+    BitBoard_t shifted = (k >= 0) ? (m >> k) : (m << -k);
+    uint8_t cols = (dc >= 0) ? (uint8_t)(0xFF >> dc) : (uint8_t)(0xFF << -dc);
+    return shifted & (cols * 0x0101010101010101ULL);
+}
+
+// Маски ходів: біт (r, c) у h_moves — обмін (r, c)<->(r, c+1) дає лінію, у v_moves — (r, c)<->(r+1, c)
+static void BB_MoveMasks(const Game_t *g, BitBoard_t *h_moves, BitBoard_t *v_moves) {
+    *h_moves = 0;
+    *v_moves = 0;
+
+    for (int k = 1; k <= GAME_NUM_COLORS; k++) {
+        BitBoard_t m = g->color_masks[k];
+        if (!m) continue;
+
+        BitBoard_t shapes[6];
+        for (int i = 0; i < 6; i++) {
+            const MovePattern_t *p = &kMovePatterns[i];
+            shapes[i] = BB_Shift(m, p->dr1, p->dc1) & BB_Shift(m, p->dr2, p->dc2);
+        }
+
+        for (int from = 0; from < 4; from++) {
+            const MoveSource_t *src = &kMoveSources[from];
+            BitBoard_t targets = 0;
+            for (int i = 0; i < 6; i++) {
+                if (src->patterns & (1u << i)) targets |= shapes[i];
+            }
+            // Ціль ще не цього кольору, а в джерелі — кулька цього кольору
+            targets &= ~m & BB_Shift(m, src->dr, src->dc);
+
+            // Переносимо біт цілі на ліву/верхню клітинку обміну
+            if (from == FROM_LEFT)       *h_moves |= targets >> 1;
+            else if (from == FROM_RIGHT) *h_moves |= targets;
+            else if (from == FROM_ABOVE) *v_moves |= targets >> BOARD_COLS;
+            else                         *v_moves |= targets;
+        }
+    }
+}
+#elif GAME_USE_SWAR
+int Game_IsMatchPresent(const Game_t *g) {
+    uint32_t marked[BOARD_ROWS];
+    SWAR_Lines(g, GAME_LINE_MASK(BOARD_ROWS), GAME_LINE_MASK(BOARD_COLS), marked);
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        if (marked[r]) return 1;
+    }
+    return 0;
+}
+
+static void SWAR_Build(Game_t *g) {
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        uint32_t row = 0;
+        for (int c = 0; c < BOARD_COLS; c++) row |= (uint32_t)(g->board[r][c] & 0xF) << (4 * c);
+        g->rows[r] = row;
+    }
+}
+
+// Прапорці тетрад, відмінних від нуля (без переносів між тетрадами)
+static uint32_t SWAR_NonZero(uint32_t x) {
+    return (((x & SWAR_LOW3) + SWAR_LOW3) | x) & SWAR_FLAGS;
+}
+
+static uint32_t SWAR_Row(const Game_t *g, int r) {
+    return (r >= 0 && r < BOARD_ROWS) ? g->rows[r] : 0;
+}
+
+// Прапорці всіх клітинок ліній з 3+ кульок: горизонтальні — лише в рядках h_rows,
+// вертикальні — лише в стовпчиках v_cols (бітові маски, як dirty_rows / dirty_cols)
+static void SWAR_Lines(const Game_t *g, uint32_t h_rows, uint32_t v_cols, uint32_t marked[BOARD_ROWS]) {
+    uint32_t v_region = 0;
     for (int c = 0; c < BOARD_COLS; c++) {
-        for (int r = 0; r <= BOARD_ROWS - 3; r++) {
-            uint8_t color = board[r][c];
+        if (v_cols & (1u << c)) v_region |= SWAR_FLAG(c);
+    }
+    for (int r = 0; r < BOARD_ROWS; r++) marked[r] = 0;
+
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        uint32_t row = g->rows[r];
+        uint32_t nz = SWAR_NonZero(row);
+        if (h_rows & (1u << r)) {
+            uint32_t eq = SWAR_EQ(row, row >> 4); // c == c+1
+            uint32_t h = nz & eq & (eq >> 4) & SWAR_H_STARTS;
+            marked[r] |= h | (h << 4) | (h << 8);
+        }
+        if (r + 2 < BOARD_ROWS) {
+            uint32_t v = nz & v_region & SWAR_EQ(row, g->rows[r + 1]) & SWAR_EQ(row, g->rows[r + 2]);
+            marked[r] |= v;
+            marked[r + 1] |= v;
+            marked[r + 2] |= v;
+        }
+    }
+}
+
+/* Маски ходів у прапорцях тетрад: h_moves[r] — обмін (r, c)<->(r, c+1) дає лінію,
+ * v_moves[r] — (r, c)<->(r+1, c). Ціль t отримує кульку з джерела s; хід є, якщо
+ * s не порожня, колір s відрізняється від t і збігається з обома клітинками однієї
+ * з форм kMovePatterns, дозволених для цього напрямку (маски kMoveSources).
+ *
+ * Рівність кольорів транзитивна, тож форма перевіряється ланцюжком s = p1 = p2
+ * через шість слів-відношень на рядок, пораховані один раз:
+ *   h1: (r,c) = (r,c+1)   h2: (r,c) = (r,c+2)   dp: (r,c) = (r+1,c+1)
+ *   v1: (r,c) = (r+1,c)   v2: (r,c) = (r+2,c)   dm: (r,c) = (r+1,c-1)
+ * Відношення з якорем у (r+a, c+b) переноситься на t зсувом слова рядка r+a на 4b біт.
+ * Фантомні нулі за межами поля ніколи не дорівнюють непорожній s, тож ланцюжок, що
+ * починається з s, не може пройти через них. */
+static void SWAR_MoveMasks(const Game_t *g, uint32_t h_moves[BOARD_ROWS], uint32_t v_moves[BOARD_ROWS]) {
+    // Індекс +2: рядки -2..-1 і BOARD_ROWS..+1 — нулі
+    uint32_t h1[BOARD_ROWS + 4] = { 0 }, h2[BOARD_ROWS + 4] = { 0 };
+    uint32_t v1[BOARD_ROWS + 4] = { 0 }, v2[BOARD_ROWS + 4] = { 0 };
+    uint32_t dp[BOARD_ROWS + 4] = { 0 }, dm[BOARD_ROWS + 4] = { 0 };
+
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        uint32_t t = g->rows[r], down = SWAR_Row(g, r + 1);
+        h1[r + 2] = SWAR_EQ(t, t >> 4);
+        h2[r + 2] = SWAR_EQ(t, t >> 8);
+        v1[r + 2] = SWAR_EQ(t, down);
+        v2[r + 2] = SWAR_EQ(t, SWAR_Row(g, r + 2));
+        dp[r + 2] = SWAR_EQ(t, down >> 4);
+        dm[r + 2] = SWAR_EQ(t, down << 4);
+    }
+
+    for (int r = 0; r < BOARD_ROWS; r++) {
+        const int i = r + 2; // Рядок r у масивах відношень
+        uint32_t t = g->rows[r];
+        uint32_t s, hit;
+
+        // Зліва, s = (r, c-1). Форми 2, 3, 4, 5
+        s = t << 4;
+        hit = ((h2[i] << 4) & (h1[i] >> 4)) | (dm[i - 1] & (v1[i - 2] | (dp[i] << 4))) | ((dp[i] << 4) & v1[i + 1]);
+        h_moves[r] = (hit & SWAR_NonZero(s) & SWAR_NonZero(s ^ t)) >> 4;
+
+        // Справа, s = (r, c+1). Форми 0, 3, 4, 5
+        s = t >> 4;
+        hit = ((h2[i] << 4) & (h1[i] << 8)) | (dp[i - 1] & (v1[i - 2] | (dm[i] >> 4))) | ((dm[i] >> 4) & v1[i + 1]);
+        h_moves[r] |= hit & SWAR_NonZero(s) & SWAR_NonZero(s ^ t);
+
+        // Згори, s = (r-1, c). Форми 0, 1, 2, 5
+        if (r > 0) {
+            s = g->rows[r - 1];
+            hit = (dm[i - 1] & ((h1[i] << 8) | dp[i - 1])) | (dp[i - 1] & (h1[i] >> 4)) | (v2[i - 1] & v1[i + 1]);
+            v_moves[r - 1] |= hit & SWAR_NonZero(s) & SWAR_NonZero(s ^ t);
+        }
+
+        // Знизу, s = (r+1, c). Форми 0, 1, 2, 3
+        v_moves[r] = 0;
+        if (r + 1 < BOARD_ROWS) {
+            s = g->rows[r + 1];
+            hit = ((dp[i] << 4) & ((h1[i] << 8) | (dm[i] >> 4))) | ((dm[i] >> 4) & (h1[i] >> 4)) | (v2[i - 1] & v1[i - 2]);
+            v_moves[r] = hit & SWAR_NonZero(s) & SWAR_NonZero(s ^ t);
+        }
+    }
+}
+#else
+int Game_IsMatchPresent(const Game_t *g) {
+    for (int r = 0; r < GAME_ROWS(g); r++) {
+        for (int c = 0; c <= GAME_COLS(g) - 3; c++) {
+            uint8_t color = g->board[r][c];
+            if (color == 0) continue;
+            if (g->board[r][c+1] == color && g->board[r][c+2] == color) return 1;
+        }
+    }
+    for (int c = 0; c < GAME_COLS(g); c++) {
+        for (int r = 0; r <= GAME_ROWS(g) - 3; r++) {
+            uint8_t color = g->board[r][c];
             if (color == 0) continue;
-            if (board[r+1][c] == color && board[r+2][c] == color) return 1;
+            if (g->board[r+1][c] == color && g->board[r+2][c] == color) return 1;
         }
     }
     return 0;
 }
+
+// Чи утворить кулька кольору color, що прилетіла в (r, c) з напрямку from, лінію
+static int Game_PatternHit(const Game_t *g, int r, int c, uint8_t color, int from) {
+    const MoveSource_t *src = &kMoveSources[from];
+    for (int i = 0; i < 6; i++) {
+        if (!(src->patterns & (1u << i))) continue;
+        const MovePattern_t *p = &kMovePatterns[i];
+        int ra = r + p->dr1, ca = c + p->dc1;
+        int rb = r + p->dr2, cb = c + p->dc2;
+        if (ra < 0 || ra >= GAME_ROWS(g) || ca < 0 || ca >= GAME_COLS(g)) continue;
+        if (rb < 0 || rb >= GAME_ROWS(g) || cb < 0 || cb >= GAME_COLS(g)) continue;
+        if (g->board[ra][ca] == color && g->board[rb][cb] == color) return 1;
+    }
+    return 0;
+}
+#endif
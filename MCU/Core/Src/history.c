@@ -0,0 +1,164 @@
+#include "history.h"
+#include <string.h>
+
+/* Запис у кільці (числа — little-endian):
+ *   n (2) | score ^ score' (4) | rng ^ rng' (4) | n клітинок по 2 байти | n (2)
+ * Клітинка — (r * BOARD_COLS + c) у бітах 0..11 і old ^ new у бітах 12..15.
+ * n записано з обох кінців, щоб ходити по кільцю і вперед (REDO), і назад (UNDO). */
+#define HISTORY_RECORD_BYTES(n) (12u + 2u * (uint32_t)(n))
+
+_Static_assert(BOARD_ROWS * BOARD_COLS <= 4096 && GAME_NUM_COLORS < 16,
+               "History cell encoding needs a 12-bit position and a 4-bit colour");
+
+/* --- ПРОТОТИПИ --- */
+static uint16_t History_Wrap(uint32_t pos);
+static uint16_t History_Get16(const History_t *h, uint32_t pos);
+static uint32_t History_Get32(const History_t *h, uint32_t pos);
+static void History_Put16(History_t *h, uint32_t *pos, uint16_t v);
+static void History_Put32(History_t *h, uint32_t *pos, uint32_t v);
+static void History_DropOldest(History_t *h);
+static void History_Apply(const History_t *h, Game_t *g, uint32_t start, uint32_t touched[BOARD_ROWS]);
+
+/* --- ПУБЛІЧНІ ФУНКЦІЇ --- */
+
+void History_Clear(History_t *h) {
+    h->tail = 0;
+    h->cursor = 0;
+    h->undo_bytes = 0;
+    h->redo_bytes = 0;
+    h->undo_count = 0;
+    h->redo_count = 0;
+    h->pending = 0;
+}
+
+void History_Begin(History_t *h, const Game_t *g) {
+    memcpy(h->before, g->board, sizeof(h->before));
+    h->score_before = g->score;
+    h->rng_before = g->rng_state;
+    h->pending = 1;
+}
+
+void History_Commit(History_t *h, const Game_t *g) {
+    if (!h->pending) return;
+    h->pending = 0;
+
+    uint16_t n = 0;
+    for (int r = 0; r < GAME_ROWS(g); r++) {
+        for (int c = 0; c < GAME_COLS(g); c++) {
+            if (g->board[r][c] != h->before[r][c]) n++;
+        }
+    }
+    uint32_t score_x = g->score ^ h->score_before;
+    uint32_t rng_x = g->rng_state ^ h->rng_before;
+    if (n == 0 && score_x == 0 && rng_x == 0) return; // Відхилений обмін — повтор лишається доступним
+
+    uint32_t len = HISTORY_RECORD_BYTES(n);
+    if (len > HISTORY_BYTES) {
+        // Хід не вміщається навіть у порожнє кільце: через нього назад не пройти
+        History_Clear(h);
+        return;
+    }
+
+    // Новий хід відкидає скасовані; найстаріші витісняються, доки не звільниться місце
+    h->redo_bytes = 0;
+    h->redo_count = 0;
+    while (h->undo_bytes + len > HISTORY_BYTES) History_DropOldest(h);
+
+    uint32_t pos = h->cursor;
+    History_Put16(h, &pos, n);
+    History_Put32(h, &pos, score_x);
+    History_Put32(h, &pos, rng_x);
+    for (int r = 0; r < GAME_ROWS(g); r++) {
+        for (int c = 0; c < GAME_COLS(g); c++) {
+            uint8_t x = g->board[r][c] ^ h->before[r][c];
+            if (x) History_Put16(h, &pos, (uint16_t)((r * BOARD_COLS + c) | (x << 12)));
+        }
+    }
+    History_Put16(h, &pos, n);
+
+    h->cursor = (uint16_t)pos;
+    h->undo_bytes += (uint16_t)len;
+    h->undo_count++;
+}
+
+uint8_t History_Undo(History_t *h, Game_t *g, uint32_t touched[BOARD_ROWS]) {
+    if (h->undo_count == 0) return 0;
+
+    uint32_t len = HISTORY_RECORD_BYTES(History_Get16(h, h->cursor + HISTORY_BYTES - 2u));
+    uint16_t start = History_Wrap(h->cursor + HISTORY_BYTES - len);
+    History_Apply(h, g, start, touched);
+
+    h->cursor = start;
+    h->undo_bytes -= (uint16_t)len;
+    h->redo_bytes += (uint16_t)len;
+    h->undo_count--;
+    h->redo_count++;
+    return 1;
+}
+
+uint8_t History_Redo(History_t *h, Game_t *g, uint32_t touched[BOARD_ROWS]) {
+    if (h->redo_count == 0) return 0;
+
+    uint32_t len = HISTORY_RECORD_BYTES(History_Get16(h, h->cursor));
+    History_Apply(h, g, h->cursor, touched);
+
+    h->cursor = History_Wrap(h->cursor + len);
+    h->undo_bytes += (uint16_t)len;
+    h->redo_bytes -= (uint16_t)len;
+    h->undo_count++;
+    h->redo_count--;
+    return 1;
+}
+
+/* --- ПРИВАТНІ ФУНКЦІЇ --- */
+
+// Позиції завжди менші за 2 * HISTORY_BYTES, тож одного віднімання досить
+static uint16_t History_Wrap(uint32_t pos) {
+    return (uint16_t)(pos >= HISTORY_BYTES ? pos - HISTORY_BYTES : pos);
+}
+
+static uint16_t History_Get16(const History_t *h, uint32_t pos) {
+    return (uint16_t)(h->buf[History_Wrap(pos)] | (h->buf[History_Wrap(pos + 1u)] << 8));
+}
+
+static uint32_t History_Get32(const History_t *h, uint32_t pos) {
+    return History_Get16(h, pos) | ((uint32_t)History_Get16(h, History_Wrap(pos + 2u)) << 16);
+}
+
+static void History_Put16(History_t *h, uint32_t *pos, uint16_t v) {
+    h->buf[*pos] = (uint8_t)v;
+    *pos = History_Wrap(*pos + 1u);
+    h->buf[*pos] = (uint8_t)(v >> 8);
+    *pos = History_Wrap(*pos + 1u);
+}
+
+static void History_Put32(History_t *h, uint32_t *pos, uint32_t v) {
+    History_Put16(h, pos, (uint16_t)v);
+    History_Put16(h, pos, (uint16_t)(v >> 16));
+}
+
+static void History_DropOldest(History_t *h) {
+    uint32_t len = HISTORY_RECORD_BYTES(History_Get16(h, h->tail));
+    h->tail = History_Wrap(h->tail + len);
+    h->undo_bytes -= (uint16_t)len;
+    h->undo_count--;
+}
+
+// Накладає запис на поле: та сама дія і для скасування, і для повтору
+static void History_Apply(const History_t *h, Game_t *g, uint32_t start, uint32_t touched[BOARD_ROWS]) {
+    uint16_t n = History_Get16(h, start);
+    g->score ^= History_Get32(h, start + 2u);
+    g->rng_state ^= History_Get32(h, start + 6u);
+
+    uint32_t pos = History_Wrap(start + 10u);
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t v = History_Get16(h, pos);
+        pos = History_Wrap(pos + 2u);
+        int cell = v & 0x0FFF;
+        int r = cell / BOARD_COLS;
+        int c = cell % BOARD_COLS;
+        g->board[r][c] ^= (uint8_t)(v >> 12);
+        if (touched) touched[r] |= 1u << c;
+    }
+    Game_MarkAllDirty(g);
+}
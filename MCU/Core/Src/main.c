@@ -17,6 +17,12 @@
 #include <string.h>
 #include "game.h"
 #include "save.h"
+#include "history.h"
+#include "search.h"
+#include "replay.h"
+#include "crc8.h"
+#include "bench.h"
+#include "txring.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -36,6 +42,21 @@ typedef struct {
 #define PACKET_SIZE 6
 #define TIMEOUT_MS  10
 #define CMD_UPDATE_CELL 0x16
+#define CMD_MATCH_GROUP 0x1E
+#define CMD_GET_REPLAY  0x1F
+#define CMD_BOARD_PACKED 0x61
+#define CMD_BOARD_DELTA  0x62
+#define UI_EVENT_LOG_SIZE GAME_MAX_STEP_EVENTS // Вистачає на будь-який крок анімації
+#define CAP_PACKED_BOARD 0x01 // Клієнт приймає поле кадром 0x61
+#define CAP_DELTA_FRAME  0x02 // Клієнт приймає зміни кроку анімації кадром 0x62
+#define CAP_CASCADE_BURST 0x04 // Каскад — без пауз між кроками, темп задає клієнт (лише з CAP_DELTA_FRAME)
+#define CAP_LOCAL_FALL   0x08 // Падіння анімує клієнт: один кадр 0x62 на падіння, кінцевий стан (лише з CAP_DELTA_FRAME)
+#define PACKED_BOARD_BYTES (3 + (BOARD_ROWS * BOARD_COLS + 1) / 2 + 1)
+#define DELTA_FRAME_BYTES  (3 + (BOARD_ROWS * BOARD_COLS + 7) / 8 + (BOARD_ROWS * BOARD_COLS + 1) / 2 + 1)
+
+#if DELTA_FRAME_BYTES > TXRING_SIZE || PACKED_BOARD_BYTES > TXRING_SIZE
+#error "TXRING_SIZE must hold the longest board frame"
+#endif
 /* USER CODE END PD */
 
 /* Private variables ---------------------------------------------------------*/
@@ -46,31 +67,58 @@ uint8_t rx_idx = 0;
 volatile uint8_t packet_received_flag = 0;
 uint32_t last_byte_tick = 0;
 Packet_t current_packet;
+TxRing_t uart_tx; // Черга на передачу; спорожнює переривання USART1
+volatile uint16_t uart_tx_len = 0; // Байтів черги, які зараз передає HAL_UART_Transmit_IT (0 — UART вільний)
 
 extern char current_player_name[16];
-uint8_t board_snapshot[BOARD_ROWS][BOARD_COLS];
+Game_t game; // Єдиний екземпляр гри у прошивці
+GameEvent_t ui_events[UI_EVENT_LOG_SIZE]; // Журнал подій рушія між кроками анімації
+History_t history; // Ходи для UNDO/REDO
+Replay_t replay;   // Запис гри від зерна для перевірки рекорду (0x1F)
 uint32_t anim_speed_ms = 150;
+GameMove_t hint_move;
+uint8_t client_caps = 0; // CAP_* з 0x60; старий клієнт його не шле й отримує поле по клітинці
+uint8_t hint_valid = 0; // Підказка рахується лише на запит 0x17 і до наступної зміни поля
+// Підказка: expectimax на 1 хід, 4 вибірки поповнення, без годинника (~сотні обмінів)
+static const SearchConfig_t hint_search = { .max_depth = 1, .samples = 4 };
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 
 /* USER CODE BEGIN 0 */
-uint8_t CRC8_Calc(uint8_t *data, uint8_t len)
+// Передає наступний суцільний шматок черги, якщо UART вільний. Поза перериванням —
+// лише із забороненими перериваннями, щоб не змагатися з HAL_UART_TxCpltCallback.
+void UART_Tx_Start(void)
 {
-    uint8_t crc = 0x00;
-    uint8_t i, j;
-    for (i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (j = 0; j < 8; j++) {
-            if (crc & 0x80) {
-                crc = (crc << 1) ^ 0x07;
-            } else {
-                crc <<= 1;
-            }
-        }
+    const uint8_t *chunk;
+    uint16_t n;
+
+    if (uart_tx_len) return;
+    n = TxRing_Peek(&uart_tx, &chunk);
+    if (n == 0) return;
+    uart_tx_len = n;
+    if (HAL_UART_Transmit_IT(&huart1, (uint8_t *)chunk, n) != HAL_OK) uart_tx_len = 0; // Повтор — з головного циклу
+}
+
+// Ставить байти в чергу й одразу повертається, передає їх переривання USART1 (TXE).
+// Якщо черга повна — чекає, поки переривання звільнить місце (зворотний тиск): пакет
+// не губиться й не розривається. Скільки вміщається без чекання — UART_TxFree.
+void UART_Send(const uint8_t *data, uint16_t len)
+{
+    while (!TxRing_Write(&uart_tx, data, len)) {
+        __disable_irq();
+        UART_Tx_Start();
+        __enable_irq();
     }
-    return crc;
+    __disable_irq();
+    UART_Tx_Start();
+    __enable_irq();
+}
+
+uint16_t UART_TxFree(void)
+{
+    return TxRing_Free(&uart_tx);
 }
 
 void Send_Packet(uint8_t cmd, uint8_t r, uint8_t c, uint8_t data, uint8_t status)
@@ -82,37 +130,155 @@ void Send_Packet(uint8_t cmd, uint8_t r, uint8_t c, uint8_t data, uint8_t status
     tx_buf[3] = data;
     tx_buf[4] = status;
     tx_buf[5] = CRC8_Calc(tx_buf, 5);
-    HAL_UART_Transmit(&huart1, tx_buf, PACKET_SIZE, 100);
+    UART_Send(tx_buf, PACKET_SIZE);
 }
 
-void Send_Board_Diff(void)
+void Send_Touched_Cells(const Game_t *g, const uint32_t touched[BOARD_ROWS])
 {
-    for (uint8_t r = 0; r < BOARD_ROWS; r++) {
-        for (uint8_t c = 0; c < BOARD_COLS; c++) {
-            if (board[r][c] != board_snapshot[r][c]) {
-                Send_Packet(CMD_UPDATE_CELL, r, c, board[r][c], 0xAA);
-                HAL_Delay(2);
+    for (uint8_t r = 0; r < GAME_ROWS(g); r++) {
+        for (uint8_t c = 0; c < GAME_COLS(g); c++) {
+            if (touched[r] & (1u << c)) {
+                Send_Packet(CMD_UPDATE_CELL, r, c, g->board[r][c], 0xAA);
             }
         }
     }
 }
 
-void UI_Update_Step(void)
+// Змінені за крок клітинки одним кадром: [62 rows cols маска кольори CRC]. Біт i маски
+// (молодший біт байта — перший) — клітинка i = r * cols + c; далі кольори позначених
+// клітинок по 4 біти в тому ж порядку, перший — у старшій тетраді.
+void Send_Delta_Frame(const Game_t *g, const uint32_t touched[BOARD_ROWS])
 {
-    Send_Board_Diff();
-    memcpy(board_snapshot, board, sizeof(board_snapshot));
-    if (anim_speed_ms > 0) HAL_Delay(anim_speed_ms);
+    uint8_t frame[DELTA_FRAME_BYTES] = {0};
+    uint16_t mask_bytes = (GAME_ROWS(g) * GAME_COLS(g) + 7) / 8;
+    uint8_t *colors = &frame[3 + mask_bytes];
+    uint16_t i = 0, n = 0;
+
+    frame[0] = CMD_BOARD_DELTA;
+    frame[1] = GAME_ROWS(g);
+    frame[2] = GAME_COLS(g);
+    for (uint8_t r = 0; r < GAME_ROWS(g); r++) {
+        for (uint8_t c = 0; c < GAME_COLS(g); c++, i++) {
+            if (!(touched[r] & (1u << c))) continue;
+            frame[3 + i / 8] |= (uint8_t)(1u << (i % 8));
+            colors[n / 2] |= (n & 1) ? g->board[r][c] : (uint8_t)(g->board[r][c] << 4);
+            n++;
+        }
+    }
+    if (n == 0) return;
+
+    uint16_t len = 3 + mask_bytes + (n + 1) / 2;
+    frame[len] = CRC8_Calc(frame, len);
+    UART_Send(frame, len + 1);
+}
+
+// Надсилає лише клітинки, яких торкнулися події журналу, — без копії поля й порівняння.
+// Спершу заголовки груп згорання 0x1E. Клієнту з CAP_DELTA_FRAME — один кадр 0x62 на крок
+// (згорілі кульки в ньому — з кольором 0), іншим — клітинки пакетами 0x16: згорілі
+// одразу за заголовком своєї групи, решта — після всіх груп.
+void Send_Event_Cells(const Game_t *g)
+{
+    uint32_t touched[BOARD_ROWS] = {0}; // Біт c — клітинку (r, c) треба надіслати
+    const GameEvent_t *group = NULL;    // GROUP, що чекає на свій SCORE
+    uint8_t delta = client_caps & CAP_DELTA_FRAME;
+
+    for (uint16_t i = 0; i < g->event_count; i++) {
+        const GameEvent_t *e = &g->events[i];
+        switch (e->type) {
+            case GAME_EV_SWAP:
+                touched[e->a] |= 1u << e->b;
+                touched[e->a + e->c] |= 1u << (e->b + !e->c);
+                break;
+            case GAME_EV_GROUP:
+                group = e;
+                break;
+            case GAME_EV_SCORE: // Очки групи вміщаються у 16 біт (таблиця — uint16_t)
+                if (group) Send_Packet(CMD_MATCH_GROUP, group->a, group->b, e->b, e->c);
+                group = NULL;
+                break;
+            case GAME_EV_CLEAR:
+                if (delta) {
+                    touched[e->a] |= 1u << e->b;
+                } else {
+                    Send_Packet(CMD_UPDATE_CELL, e->a, e->b, 0, 0xAA);
+                }
+                break;
+            case GAME_EV_SPAWN:
+                touched[e->a] |= 1u << e->b;
+                break;
+            case GAME_EV_FALL:
+                touched[e->a] |= 1u << e->c;
+                touched[e->b] |= 1u << e->c;
+                break;
+            default:
+                break;
+        }
+    }
+    if (delta) Send_Delta_Frame(g, touched);
+    else Send_Touched_Cells(g, touched);
+}
+
+// Усе поле одним кадром: [61 rows cols клітинки по 4 біти CRC], парна клітинка
+// (r * cols + c) — у старшій тетраді. 8x8 — 36 байт замість 64 пакетів 0x16.
+void Send_Packed_Board(void)
+{
+    uint8_t frame[PACKED_BOARD_BYTES] = {0};
+    uint16_t len = 3, i = 0;
+
+    frame[0] = CMD_BOARD_PACKED;
+    frame[1] = GAME_ROWS(&game);
+    frame[2] = GAME_COLS(&game);
+    for (uint8_t r = 0; r < GAME_ROWS(&game); r++) {
+        for (uint8_t c = 0; c < GAME_COLS(&game); c++, i++) {
+            frame[len + i / 2] |= (i & 1) ? game.board[r][c] : (uint8_t)(game.board[r][c] << 4);
+        }
+    }
+    len += (i + 1) / 2;
+    frame[len] = CRC8_Calc(frame, len);
+    UART_Send(frame, len + 1);
 }
 
 void Send_Full_Board(void)
 {
-    for (uint8_t r = 0; r < BOARD_ROWS; r++) {
-        for (uint8_t c = 0; c < BOARD_COLS; c++) {
-            Send_Packet(CMD_UPDATE_CELL, r, c, board[r][c], 0xAA);
-            HAL_Delay(2);
+    if (client_caps & CAP_PACKED_BOARD) {
+        Send_Packed_Board();
+        return;
+    }
+    for (uint8_t r = 0; r < GAME_ROWS(&game); r++) {
+        for (uint8_t c = 0; c < GAME_COLS(&game); c++) {
+            Send_Packet(CMD_UPDATE_CELL, r, c, game.board[r][c], 0xAA);
         }
     }
 }
+
+// Запис гри: [1F n_h n_l 00 AA] з довжиною файлу в байтах, далі файл по 4 байти
+// у пакетах [1F b0 b1 b2 b3] (останній доповнено нулями)
+void Send_Replay(void)
+{
+    uint8_t header[REPLAY_HEADER_BYTES];
+    uint8_t chunk[4];
+    uint16_t total = REPLAY_HEADER_BYTES + replay.len;
+
+    Replay_WriteHeader(&replay, &game, header);
+    Send_Packet(CMD_GET_REPLAY, (uint8_t)(total >> 8), (uint8_t)total, 0, 0xAA);
+    for (uint16_t i = 0; i < total; i += 4) {
+        for (uint8_t k = 0; k < 4; k++) {
+            uint16_t j = i + k;
+            chunk[k] = (j >= total) ? 0 : (j < REPLAY_HEADER_BYTES) ? header[j] : replay.buf[j - REPLAY_HEADER_BYTES];
+        }
+        Send_Packet(CMD_GET_REPLAY, chunk[0], chunk[1], chunk[2], chunk[3]);
+    }
+}
+
+void UI_Update_Step(Game_t *g, void *ctx)
+{
+    (void)ctx;
+    if (g->event_overflow) Send_Full_Board();
+    else Send_Event_Cells(g);
+    Game_ClearEvents(g);
+    // Клієнт з CAP_CASCADE_BURST програє кадри 0x62 сам, плата одразу береться за наступну команду
+    if (anim_speed_ms > 0 && !(client_caps & CAP_CASCADE_BURST)) HAL_Delay(anim_speed_ms);
+}
 /* USER CODE END 0 */
 
 int main(void)
@@ -124,12 +290,25 @@ int main(void)
 
   /* USER CODE BEGIN 2 */
   __HAL_UART_FLUSH_DRREGISTER(&huart1);
+  TxRing_Init(&uart_tx);
   HAL_UART_Receive_IT(&huart1, &rx_byte, 1);
-  Game_Init();
+  Game_Setup(&game, UI_Update_Step, NULL);
+  Game_SetEventLog(&game, ui_events, UI_EVENT_LOG_SIZE);
+  Game_Init(&game, HAL_GetTick());
+  History_Clear(&history);
+  Replay_Clear(&replay, 0);
   /* USER CODE END 2 */
 
   while (1)
   {
+      // Передача не стартувала (HAL_UART_Transmit_IT не HAL_OK), а в черзі лишилися байти:
+      // без повтору остання відповідь чекала б наступного UART_Send
+      if (uart_tx_len == 0 && TxRing_Used(&uart_tx)) {
+          __disable_irq();
+          UART_Tx_Start();
+          __enable_irq();
+      }
+
       if (packet_received_flag == 1)
       {
           current_packet.cmd    = rx_buffer[0];
@@ -143,37 +322,53 @@ int main(void)
           {
               switch (current_packet.cmd)
               {
-                  case 0x10: // НОВА ГРА
-                      Game_Init();
+                  case 0x10: // НОВА ГРА (ADDR_H..DATA_L — зерно, 0 = обирає плата)
+                  {
+                      uint32_t seed = ((uint32_t)current_packet.addr_h << 24) | ((uint32_t)current_packet.addr_l << 16) |
+                                      ((uint32_t)current_packet.data_h << 8) | current_packet.data_l;
+                      Game_Init(&game, seed ? seed : HAL_GetTick());
+                      History_Clear(&history);
+                      Replay_Clear(&replay, 0);
+                      hint_valid = 0;
                       Send_Packet(0x10, 0, 0, 0, 0xAA);
                       Send_Full_Board();
-                      break;
+                  }
+                  break;
 
                   case 0x11: // ХІД (SWAP)
                   {
-                      memcpy(board_snapshot, board, sizeof(board_snapshot));
-                      uint8_t success = Game_Swap(current_packet.addr_h, current_packet.addr_l,
+                      History_Begin(&history, &game);
+                      uint8_t success = Game_Swap(&game, current_packet.addr_h, current_packet.addr_l,
                                                   current_packet.data_h, current_packet.data_l);
                       if (success) {
+                          Replay_RecordSwap(&replay, &game, current_packet.addr_h, current_packet.addr_l,
+                                            current_packet.data_h, current_packet.data_l);
                           Send_Packet(0x11, 0, 0, 0, 0xAA);
-                          UI_Update_Step();
-                          Game_RunGravityLoop();
-
-                          // Перевірка на автоматичне завершення (немає ходів)
-                          if (Game_HasPossibleMoves() == 0) {
-                              Update_Leaderboard(score, current_player_name);
-                              Send_Packet(0x11, 0, 0, 0, 0xDD); // Повідомлення Python про Game Over
+                          UI_Update_Step(&game, NULL);
+                          Game_RunGravityLoop(&game);
+
+                          // Немає ходів — перегенеровуємо поле замість Game Over: гра триває,
+                          // а таблиця рекордів пишеться у Flash лише з FINISH (0x12).
+                          hint_valid = 0;
+                          if (!Game_FindMoves(&game, NULL, 1)) {
+                              Game_Shuffle(&game);
+                              Send_Full_Board(); // Нове поле цілком — журнал його не описує
+                              Send_Packet(0x18, 0, 0, 0, 0xDD); // Повідомлення Python: тупик, поле перемішано
                           }
                       } else {
                           Send_Packet(0x11, 0, 0, 0, 0xEE);
                       }
+                      History_Commit(&history, &game); // Разом з перемішуванням після тупика
                   }
                   break;
 
                   case 0x12: // ПРИМУСОВЕ ЗАВЕРШЕННЯ (Кнопка "Finish")
                   {
-                      Update_Leaderboard(score, current_player_name); // Запис у таблицю рекордів
-                      Game_Init(); // Очищення поля
+                      Update_Leaderboard(game.score, current_player_name); // Запис у таблицю рекордів
+                      Game_Init(&game, HAL_GetTick()); // Очищення поля
+                      History_Clear(&history);
+                      Replay_Clear(&replay, 0);
+                      hint_valid = 0;
                       Send_Packet(0x12, 0, 0, 0, 0xAA); // Підтвердження
                       Send_Full_Board(); // Оновлення екрану у Python
                   }
@@ -181,12 +376,74 @@ int main(void)
 
                   case 0x15: // ОТРИМАТИ SCORE
                   {
-                      uint8_t tx_score[PACKET_SIZE] = {0x15, (uint8_t)((score>>24)&0xFF), (uint8_t)((score>>16)&0xFF), (uint8_t)((score>>8)&0xFF), (uint8_t)(score&0xFF), 0};
+                      uint8_t tx_score[PACKET_SIZE] = {0x15, (uint8_t)((game.score>>24)&0xFF), (uint8_t)((game.score>>16)&0xFF), (uint8_t)((game.score>>8)&0xFF), (uint8_t)(game.score&0xFF), 0};
                       tx_score[5] = CRC8_Calc(tx_score, 5);
-                      HAL_UART_Transmit(&huart1, tx_score, PACKET_SIZE, 100);
+                      UART_Send(tx_score, PACKET_SIZE);
                   }
                   break;
 
+                  case 0x17: // ПІДКАЗКА (хід з найбільшими очікуваними очками)
+                      if (!hint_valid) {
+                          SearchMove_t best;
+                          if (Search_BestMoves(&game, &hint_search, &best, 1, NULL)) {
+                              hint_move = best.move;
+                              hint_valid = 1;
+                          }
+                      }
+                      if (hint_valid) {
+                          Send_Packet(0x17, hint_move.r1, hint_move.c1, hint_move.r2, hint_move.c2);
+                      } else {
+                          Send_Packet(0x17, 0, 0, 0, 0xDD);
+                      }
+                      break;
+
+                  case 0x18: // ПЕРЕМІШАТИ ПОЛЕ (рахунок зберігається)
+                      History_Begin(&history, &game);
+                      Game_Shuffle(&game);
+                      History_Commit(&history, &game);
+                      Replay_RecordOp(&replay, REPLAY_OP_SHUFFLE);
+                      Send_Packet(0x18, 0, 0, 0, 0xAA);
+                      Send_Full_Board();
+                      hint_valid = 0;
+                      break;
+
+                  case 0x19: // ГЕОМЕТРІЯ ПОЛЯ (рядки, стовпчики, кількість кольорів)
+                      Send_Packet(0x19, GAME_ROWS(&game), GAME_COLS(&game), GAME_COLORS(&game), 0xAA);
+                      break;
+
+                  case 0x1A: // СКАСУВАТИ ХІД (UNDO)
+                  case 0x1B: // ПОВТОРИТИ ХІД (REDO)
+                  {
+                      uint32_t touched[BOARD_ROWS] = {0};
+                      uint8_t done = (current_packet.cmd == 0x1A) ? History_Undo(&history, &game, touched)
+                                                                  : History_Redo(&history, &game, touched);
+                      if (done) {
+                          hint_valid = 0;
+                          Replay_RecordOp(&replay, (current_packet.cmd == 0x1A) ? REPLAY_OP_UNDO : REPLAY_OP_REDO);
+                          Send_Packet(current_packet.cmd, 0, 0, 0, 0xAA);
+                          Send_Touched_Cells(&game, touched);
+                      } else {
+                          Send_Packet(current_packet.cmd, 0, 0, 0, 0xEE); // Історія порожня
+                      }
+                  }
+                  break;
+
+                  case 0x1C: // ВІДБИТОК ПОЛЯ (звірка клієнта з платою)
+                  {
+                      uint32_t fp = Game_Fingerprint(&game);
+                      Send_Packet(0x1C, (uint8_t)(fp >> 24), (uint8_t)(fp >> 16), (uint8_t)(fp >> 8), (uint8_t)fp);
+                  }
+                  break;
+
+                  case 0x1D: // УСЕ ПОЛЕ (відновлення після розсинхронізації)
+                      Send_Packet(0x1D, 0, 0, 0, 0xAA);
+                      Send_Full_Board();
+                      break;
+
+                  case 0x1F: // ЗАПИС ГРИ (файл replay.h; клієнт просить його перед FINISH)
+                      Send_Replay();
+                      break;
+
                   case 0x20: // ПРИЙНЯТИ ІМ'Я
                   {
                       uint8_t chunk = current_packet.addr_h;
@@ -202,14 +459,16 @@ int main(void)
                   break;
 
                   case 0x30: // ЗБЕРЕГТИ СТАН ГРИ (Слот)
-                      Save_Game(current_packet.addr_h);
+                      Save_Game(&game, current_packet.addr_h);
                       Send_Packet(0x30, current_packet.addr_h, 0, 0, 0xAA);
                       break;
 
                   case 0x31: // ЗАВАНТАЖИТИ СТАН ГРИ
-                      if (Load_Game(current_packet.addr_h)) {
+                      if (Load_Game(&game, current_packet.addr_h)) {
+                          History_Clear(&history);
+                          Replay_Clear(&replay, REPLAY_FLAG_LOADED);
+                          hint_valid = 0;
                           Send_Packet(0x31, current_packet.addr_h, 0, 0, 0xAA);
-                          HAL_Delay(10);
                           Send_Full_Board();
                       } else {
                           Send_Packet(0x31, current_packet.addr_h, 0, 0, 0xEE);
@@ -223,31 +482,27 @@ int main(void)
         GameSaveData_t *flash_ptr = (GameSaveData_t *)FLASH_SAVE_ADDR;
 
         // Перевіряємо валідність збереження
-        if (flash_ptr[slot].magic == SAVE_MAGIC_NUMBER) {
+        if (flash_ptr[slot].magic == SAVE_SLOT_MAGIC) {
 
             // Пакет 1: символи 0, 1, 2 (Команда 0x33)
             Send_Packet(0x33, slot, flash_ptr[slot].playerName[0],
                                     flash_ptr[slot].playerName[1],
                                     flash_ptr[slot].playerName[2]);
-            HAL_Delay(5);
 
             // Пакет 2: символи 3, 4, 5 (Команда 0x34)
             Send_Packet(0x34, slot, flash_ptr[slot].playerName[3],
                                     flash_ptr[slot].playerName[4],
                                     flash_ptr[slot].playerName[5]);
-            HAL_Delay(5);
 
             // Пакет 3: символи 6, 7, 8 (Команда 0x35)
             Send_Packet(0x35, slot, flash_ptr[slot].playerName[6],
                                     flash_ptr[slot].playerName[7],
                                     flash_ptr[slot].playerName[8]);
-            HAL_Delay(5);
 
             // Пакет 4: символи 9, 10, 11 (Команда 0x36)
             Send_Packet(0x36, slot, flash_ptr[slot].playerName[9],
                                     flash_ptr[slot].playerName[10],
                                     flash_ptr[slot].playerName[11]);
-            HAL_Delay(5);
 
             // Фінальний статус: Успішно (0xAA)
             Send_Packet(0x32, slot, 0, 0, 0xAA);
@@ -268,29 +523,43 @@ break;
         // 1. Передача імені (розбиваємо 10 літер на декілька пакетів)
         // Пакет 1: символи 0, 1, 2
         Send_Packet(0x41, i, lb.leaders[i].playerName[0], lb.leaders[i].playerName[1], lb.leaders[i].playerName[2]);
-        HAL_Delay(5);
 
         // Пакет 2: символи 3, 4, 5
         Send_Packet(0x43, i, lb.leaders[i].playerName[3], lb.leaders[i].playerName[4], lb.leaders[i].playerName[5]);
-        HAL_Delay(5);
 
         // Пакет 3: символи 6, 7, 8
         Send_Packet(0x44, i, lb.leaders[i].playerName[6], lb.leaders[i].playerName[7], lb.leaders[i].playerName[8]);
-        HAL_Delay(5);
 
         // Пакет 4: символ 9 (остання літера)
         Send_Packet(0x45, i, lb.leaders[i].playerName[9], 0x00, 0x00);
-        HAL_Delay(5);
 
         // 2. Передача балів (score)
         uint8_t s_h = (uint8_t)((lb.leaders[i].score >> 8) & 0xFF);
         uint8_t s_l = (uint8_t)(lb.leaders[i].score & 0xFF);
         Send_Packet(0x42, i, 0, s_h, s_l);
-        HAL_Delay(5);
     }
 }
 break;
 
+#if GAME_BENCH
+                  case 0x50: // БЕНЧМАРК (ADDR_H — номер випадку, відповідь — такти на операцію, 24 біти)
+                      if (current_packet.addr_h < bench_case_count) {
+                          uint32_t cyc = Bench_CyclesPerOp(current_packet.addr_h);
+                          if (cyc > 0xFFFFFF) cyc = 0xFFFFFF;
+                          Send_Packet(0x50, current_packet.addr_h, (uint8_t)(cyc >> 16), (uint8_t)(cyc >> 8), (uint8_t)cyc);
+                      } else {
+                          Send_Packet(0x50, 0xFF, bench_case_count, 0, 0xEE); // Немає такого випадку; DATA_H — їх кількість
+                      }
+                      break;
+#endif
+
+                  case 0x60: // ЗНАЙОМСТВО (ADDR_H — можливості клієнта, у відповіді — спільні)
+                      client_caps = current_packet.addr_h & (CAP_PACKED_BOARD | CAP_DELTA_FRAME | CAP_CASCADE_BURST | CAP_LOCAL_FALL);
+                      if (!(client_caps & CAP_DELTA_FRAME)) client_caps &= ~(CAP_CASCADE_BURST | CAP_LOCAL_FALL); // Без кадрів кроків не розрізнити
+                      Game_SetStepFrames(&game, !(client_caps & CAP_LOCAL_FALL));
+                      Send_Packet(0x60, client_caps, 0, 0, 0xAA);
+                      break;
+
                   default:
                       Send_Packet(current_packet.cmd, 0, 0, 0, 0xFF);
                       break;
@@ -339,6 +608,14 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
   }
 }
 
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+  if (huart->Instance == USART1) {
+    TxRing_Consume(&uart_tx, uart_tx_len);
+    uart_tx_len = 0;
+    UART_Tx_Start();
+  }
+}
+
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
   if (huart->Instance == USART1) {
     __HAL_UART_CLEAR_OREFLAG(huart);
@@ -0,0 +1,125 @@
+#include "replay.h"
+#include <string.h>
+
+static const uint8_t replay_magic[4] = { 'M', '3', 'R', 'P' };
+
+/* --- ПРОТОТИПИ --- */
+static void Replay_Put32(uint8_t *p, uint32_t v);
+static uint32_t Replay_Get32(const uint8_t *p);
+
+/* --- ПУБЛІЧНІ ФУНКЦІЇ --- */
+
+void Replay_Clear(Replay_t *r, uint8_t flags) {
+    r->len = 0;
+    r->count = 0;
+    r->flags = flags;
+}
+
+void Replay_RecordOp(Replay_t *r, uint32_t code) {
+    uint8_t tmp[5];
+    uint8_t n = 0;
+
+    if (r->flags & REPLAY_FLAG_TRUNCATED) return;
+    do {
+        tmp[n] = (uint8_t)(code & 0x7F);
+        code >>= 7;
+        if (code) tmp[n] |= 0x80;
+        n++;
+    } while (code);
+
+    // Дія або вміщається цілою, або запис обривається: половина varint'а нічого не відтворить
+    if (r->len + n > REPLAY_BYTES) {
+        r->flags |= REPLAY_FLAG_TRUNCATED;
+        return;
+    }
+    memcpy(&r->buf[r->len], tmp, n);
+    r->len += n;
+    r->count++;
+}
+
+void Replay_RecordSwap(Replay_t *r, const Game_t *g, uint8_t r1, uint8_t c1, uint8_t r2, uint8_t c2) {
+    uint32_t rows = GAME_ROWS(g), cols = GAME_COLS(g);
+    uint8_t r0 = r1 < r2 ? r1 : r2;
+    uint8_t c0 = c1 < c2 ? c1 : c2;
+    uint32_t index = (r1 == r2) ? (uint32_t)r0 * (cols - 1) + c0
+                                : rows * (cols - 1) + (uint32_t)r0 * cols + c0;
+#if !GAME_RUNTIME_GEOMETRY
+    (void)g; // GAME_ROWS(g) і GAME_COLS(g) тут — сталі
+#endif
+    Replay_RecordOp(r, REPLAY_OP_SWAP + index);
+}
+
+void Replay_WriteHeader(const Replay_t *r, const Game_t *g, uint8_t out[REPLAY_HEADER_BYTES]) {
+    memcpy(out, replay_magic, sizeof(replay_magic));
+    out[4] = REPLAY_FORMAT_VERSION;
+    out[5] = GAME_ENGINE_VERSION;
+    out[6] = GAME_ROWS(g);
+    out[7] = GAME_COLS(g);
+    out[8] = GAME_COLORS(g);
+    out[9] = r->flags;
+    Replay_Put32(&out[10], g->seed);
+    Replay_Put32(&out[14], g->score);
+    Replay_Put32(&out[18], Game_Fingerprint(g));
+    Replay_Put32(&out[22], r->count);
+}
+
+int Replay_ReadHeader(const uint8_t *data, uint32_t len, ReplayHeader_t *h) {
+    if (len < REPLAY_HEADER_BYTES || memcmp(data, replay_magic, sizeof(replay_magic)) != 0) return 0;
+    h->format = data[4];
+    h->engine = data[5];
+    h->rows = data[6];
+    h->cols = data[7];
+    h->colors = data[8];
+    h->flags = data[9];
+    h->seed = Replay_Get32(&data[10]);
+    h->score = Replay_Get32(&data[14]);
+    h->fingerprint = Replay_Get32(&data[18]);
+    h->count = Replay_Get32(&data[22]);
+    return 1;
+}
+
+int Replay_NextCode(const uint8_t *data, uint32_t len, uint32_t *pos, uint32_t *code) {
+    uint32_t v = 0;
+    for (uint8_t shift = 0; shift < 32; shift += 7) {
+        if (*pos >= len) return 0;
+        uint8_t b = data[(*pos)++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *code = v;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int Replay_DecodeSwap(uint8_t rows, uint8_t cols, uint32_t code, GameMove_t *m) {
+    uint32_t horizontal = (uint32_t)rows * (cols - 1u);
+    uint32_t index = code - REPLAY_OP_SWAP;
+
+    if (code < REPLAY_OP_SWAP || cols < 2) return 0;
+    if (index < horizontal) {
+        m->r1 = m->r2 = (uint8_t)(index / (cols - 1u));
+        m->c1 = (uint8_t)(index % (cols - 1u));
+        m->c2 = m->c1 + 1;
+        return 1;
+    }
+    index -= horizontal;
+    if (index >= (rows - 1u) * (uint32_t)cols) return 0;
+    m->r1 = (uint8_t)(index / cols);
+    m->r2 = m->r1 + 1;
+    m->c1 = m->c2 = (uint8_t)(index % cols);
+    return 1;
+}
+
+/* --- ПРИВАТНІ ФУНКЦІЇ --- */
+
+static void Replay_Put32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t Replay_Get32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
@@ -2,11 +2,11 @@
 #include "stm32f0xx_hal.h"
 #include <string.h>
 
-extern uint8_t board[BOARD_ROWS][BOARD_COLS];
-extern uint32_t score;
-
 char current_player_name[16] = "Player1";
 
+_Static_assert(sizeof(GameSaveData_t) * MAX_SAVE_SLOTS <= FLASH_PAGE_BYTES,
+               "Save slots do not fit one flash page: reduce BOARD_ROWS/BOARD_COLS or MAX_SAVE_SLOTS");
+
 /* --- Внутрішня функція для запису даних у Flash --- */
 static void Flash_Write_Page(uint32_t address, uint32_t *data, uint32_t size_in_bytes) {
     HAL_FLASH_Unlock();
@@ -31,7 +31,7 @@ static void Flash_Write_Page(uint32_t address, uint32_t *data, uint32_t size_in_
 
 /* --- Логіка збереження гри (Слоти) --- */
 
-void Save_Game(uint8_t slot) {
+void Save_Game(const Game_t *g, uint8_t slot) {
     if (slot >= MAX_SAVE_SLOTS) return;
 
     GameSaveData_t all_slots[MAX_SAVE_SLOTS];
@@ -41,26 +41,36 @@ void Save_Game(uint8_t slot) {
     memcpy(all_slots, flash_ptr, sizeof(all_slots));
 
     // 2. Оновлюємо конкретний слот
-    all_slots[slot].magic = SAVE_MAGIC_NUMBER;
-    all_slots[slot].score = score;
+    all_slots[slot].magic = SAVE_SLOT_MAGIC;
+    all_slots[slot].score = g->score;
     memset(all_slots[slot].playerName, 0, 16);
     strncpy(all_slots[slot].playerName, current_player_name, 15);
-    memcpy(all_slots[slot].board, board, sizeof(board));
+    memcpy(all_slots[slot].board, g->board, sizeof(g->board));
+    all_slots[slot].seed = g->seed;
+    all_slots[slot].rng_state = g->rng_state;
+    all_slots[slot].rows = GAME_ROWS(g);
+    all_slots[slot].cols = GAME_COLS(g);
+    all_slots[slot].num_colors = GAME_COLORS(g);
+    all_slots[slot].reserved = 0;
 
     // 3. Записуємо оновлений масив назад
     Flash_Write_Page(FLASH_SAVE_ADDR, (uint32_t *)all_slots, sizeof(all_slots));
 }
 
-int Load_Game(uint8_t slot) {
+int Load_Game(Game_t *g, uint8_t slot) {
     if (slot >= MAX_SAVE_SLOTS) return 0;
 
     GameSaveData_t *flashData = (GameSaveData_t *)FLASH_SAVE_ADDR;
 
-    if (flashData[slot].magic == SAVE_MAGIC_NUMBER) {
-        score = flashData[slot].score;
+    if (flashData[slot].magic == SAVE_SLOT_MAGIC &&
+        Game_SetGeometry(g, flashData[slot].rows, flashData[slot].cols, flashData[slot].num_colors)) {
+        g->score = flashData[slot].score;
         memset(current_player_name, 0, 16);
         strncpy(current_player_name, flashData[slot].playerName, 15);
-        memcpy(board, flashData[slot].board, sizeof(board));
+        memcpy(g->board, flashData[slot].board, sizeof(g->board));
+        g->seed = flashData[slot].seed;
+        g->rng_state = flashData[slot].rng_state;
+        Game_MarkAllDirty(g);
         return 1;
     }
     return 0;
@@ -0,0 +1,133 @@
+#include "search.h"
+#include <string.h>
+
+#define SEARCH_TIME_CHECK_MASK 63 // Годинник читається раз на 64 змодельовані ходи
+
+/* --- ПРОТОТИПИ --- */
+static int32_t Search_Max(const Game_t *g, uint8_t depth, SearchRun_t *run);
+static uint32_t Search_SampleSeed(uint64_t hash, uint8_t i);
+static uint64_t Search_CacheKey(uint64_t hash, uint8_t depth);
+static void Search_CheckTime(SearchRun_t *run);
+
+/* --- ПУБЛІЧНІ ФУНКЦІЇ --- */
+
+uint16_t Search_BestMoves(const Game_t *g, const SearchConfig_t *cfg, SearchMove_t *out, uint16_t k, SearchStats_t *stats) {
+    SearchMove_t scored[GAME_MAX_MOVES]; // Результат останньої завершеної глибини, від кращого
+    union {
+        GameMove_t moves[GAME_MAX_MOVES]; // Спершу — список ходів,
+        int32_t    values[GAME_MAX_MOVES]; // далі — цінності глибини, що рахується (стек плати малий)
+    } tmp;
+    uint16_t n = Game_FindMoves(g, tmp.moves, GAME_MAX_MOVES);
+    for (uint16_t i = 0; i < n; i++) {
+        scored[i].move = tmp.moves[i];
+        scored[i].value = 0;
+    }
+    uint32_t start = cfg->now_us ? cfg->now_us() : 0;
+    uint8_t done = 0;
+    uint32_t nodes = 0;
+
+    // Ітеративне поглиблення: незавершена через час глибина відкидається цілком.
+    // Кожна наступна починає з кращих ходів попередньої — кеш заповнюється кориснішим.
+    for (uint8_t depth = 1; n && depth <= cfg->max_depth; depth++) {
+        SearchRun_t run;
+        Search_RunInit(&run, cfg, start, depth);
+        for (uint16_t i = 0; i < n && !run.aborted; i++) {
+            tmp.values[i] = Search_EvaluateMove(g, &scored[i].move, depth, &run);
+        }
+        nodes += run.nodes;
+        if (run.aborted) break;
+        done = depth;
+        for (uint16_t i = 0; i < n; i++) scored[i].value = tmp.values[i];
+        Search_SortMoves(scored, n);
+    }
+
+    if (stats) {
+        stats->depth = done;
+        stats->nodes = nodes;
+    }
+    if (k > n) k = n;
+    memcpy(out, scored, k * sizeof(SearchMove_t));
+    return k;
+}
+
+void Search_RunInit(SearchRun_t *run, const SearchConfig_t *cfg, uint32_t start_us, uint8_t depth) {
+    run->cfg = cfg;
+    run->start_us = start_us;
+    run->nodes = 0;
+    run->check_time = depth > 1 && cfg->budget_us && cfg->now_us;
+    run->aborted = 0;
+}
+
+// Вузол випадку: середнє за вибірками поповнення; хід має бути дозволеним
+int32_t Search_EvaluateMove(const Game_t *g, const GameMove_t *m, uint8_t depth, SearchRun_t *run) {
+    uint8_t samples = run->cfg->samples ? run->cfg->samples : 1;
+    int32_t sum = 0;
+
+    for (uint8_t i = 0; i < samples && !run->aborted; i++) {
+        Game_t c = *g;
+        c.ui_update = NULL; // Ні кадрів, ні журналу: лише кінцевий стан
+        c.events = NULL;
+        c.step_frames = 0;
+        c.rng_state = Search_SampleSeed(g->hash, i);
+
+        if (!Game_Swap(&c, m->r1, m->c1, m->r2, m->c2)) return 0;
+        Game_RunGravityLoop(&c);
+        run->nodes++;
+        Search_CheckTime(run);
+
+        int32_t v = (int32_t)(c.score - g->score) * SEARCH_SCALE;
+        if (depth > 1) v += Search_Max(&c, (uint8_t)(depth - 1), run);
+        sum += v;
+    }
+    return sum / samples;
+}
+
+// Вставками: ходів на полі кілька десятків, а стабільність зберігає порядок обходу
+void Search_SortMoves(SearchMove_t *moves, uint16_t n) {
+    for (uint16_t i = 1; i < n; i++) {
+        SearchMove_t m = moves[i];
+        uint16_t j = i;
+        while (j > 0 && moves[j - 1].value < m.value) {
+            moves[j] = moves[j - 1];
+            j--;
+        }
+        moves[j] = m;
+    }
+}
+
+/* --- ПРИВАТНІ ФУНКЦІЇ --- */
+
+// Вузол гравця: найкращий хід; поле без ходів нічого не додає (на платі далі перемішування)
+static int32_t Search_Max(const Game_t *g, uint8_t depth, SearchRun_t *run) {
+    const SearchConfig_t *cfg = run->cfg;
+    uint64_t key = Search_CacheKey(g->hash, depth);
+    int32_t best = 0;
+    if (cfg->cache_probe && cfg->cache_probe(cfg->cache_ctx, key, &best)) return best;
+
+    GameMove_t moves[GAME_MAX_MOVES];
+    uint16_t n = Game_FindMoves(g, moves, GAME_MAX_MOVES);
+    for (uint16_t i = 0; i < n && !run->aborted; i++) {
+        int32_t v = Search_EvaluateMove(g, &moves[i], depth, run);
+        if (v > best) best = v;
+    }
+    if (!run->aborted && cfg->cache_store) cfg->cache_store(cfg->cache_ctx, key, best, depth);
+    return best;
+}
+
+// Стан генератора для i-ї вибірки: фіналізатор murmur3 над hash поля, ніколи не 0
+static uint32_t Search_SampleSeed(uint64_t hash, uint8_t i) {
+    uint32_t x = (uint32_t)hash ^ (uint32_t)(hash >> 32) ^ ((uint32_t)(i + 1) * 0x9E3779B9u);
+    x ^= x >> 16; x *= 0x85EBCA6Bu;
+    x ^= x >> 13; x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x ? x : 0x9E3779B9u;
+}
+
+static uint64_t Search_CacheKey(uint64_t hash, uint8_t depth) {
+    return hash ^ ((uint64_t)depth * 0x9E3779B97F4A7C15ull);
+}
+
+static void Search_CheckTime(SearchRun_t *run) {
+    if (!run->check_time || (run->nodes & SEARCH_TIME_CHECK_MASK)) return;
+    if (run->cfg->now_us() - run->start_us >= run->cfg->budget_us) run->aborted = 1;
+}
@@ -0,0 +1,55 @@
+#include "txring.h"
+#include <string.h>
+
+#define TXRING_MASK (TXRING_SIZE - 1u)
+
+// Не дає компілятору перенести копіювання байтів за запис head
+#if defined(__GNUC__)
+#define TXRING_BARRIER() __asm volatile ("" ::: "memory")
+#else
+#define TXRING_BARRIER()
+#endif
+
+/* --- ПУБЛІЧНІ ФУНКЦІЇ --- */
+
+void TxRing_Init(TxRing_t *r) {
+    r->head = 0;
+    r->tail = 0;
+}
+
+uint16_t TxRing_Used(const TxRing_t *r) {
+    return (uint16_t)(r->head - r->tail);
+}
+
+uint16_t TxRing_Free(const TxRing_t *r) {
+    return (uint16_t)(TXRING_SIZE - TxRing_Used(r));
+}
+
+int TxRing_Write(TxRing_t *r, const uint8_t *data, uint16_t len) {
+    // Пакет або вміщається цілим, або не пишеться: половина кадру зіб'є клієнту синхронізацію
+    if (len > TxRing_Free(r)) return 0;
+
+    uint16_t head = r->head;
+    uint16_t at = head & TXRING_MASK;
+    uint16_t first = TXRING_SIZE - at;
+    if (first > len) first = len;
+    memcpy(&r->buf[at], data, first);
+    memcpy(r->buf, data + first, len - first);
+    TXRING_BARRIER();
+    r->head = (uint16_t)(head + len); // Останнім: споживач бачить лише вже скопійовані байти
+    return 1;
+}
+
+uint16_t TxRing_Peek(const TxRing_t *r, const uint8_t **data) {
+    uint16_t tail = r->tail;
+    uint16_t used = (uint16_t)(r->head - tail);
+    uint16_t at = tail & TXRING_MASK;
+    uint16_t to_end = TXRING_SIZE - at;
+
+    *data = &r->buf[at];
+    return used < to_end ? used : to_end;
+}
+
+void TxRing_Consume(TxRing_t *r, uint16_t len) {
+    r->tail = (uint16_t)(r->tail + len);
+}